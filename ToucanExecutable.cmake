@@ -13,7 +13,10 @@
 # limitations under the License.
 
 function(toucan_objects TARGET_NAME)
-  cmake_parse_arguments(ARG "" "" "SOURCES" ${ARGN})
+  cmake_parse_arguments(ARG "" "SPIRV_OPTIMIZATION" "SOURCES" ${ARGN})
+  if(NOT ARG_SPIRV_OPTIMIZATION)
+    set(ARG_SPIRV_OPTIMIZATION ${TOUCAN_SPIRV_OPTIMIZATION})
+  endif()
 
   set(MAKE_ACTION "make_${TARGET_NAME}")
   set(OBJ_FILE "${CMAKE_CURRENT_BINARY_DIR}/${TARGET_NAME}.o")
@@ -61,6 +64,10 @@ function(toucan_objects TARGET_NAME)
     endif()
   endif()
 
+  if(TOUCAN_REORDER_FIELDS)
+    set(REORDER_FIELDS_ARG -l)
+  endif()
+
   add_custom_command(
     OUTPUT ${OBJ_FILE} ${INIT_TYPES_CC}
     COMMAND ${TC_CMD}
@@ -68,8 +75,10 @@ function(toucan_objects TARGET_NAME)
             -i ${INIT_TYPES_CC}
             -I ${CMAKE_SOURCE_DIR}
             -I ${CMAKE_SOURCE_DIR}/samples/include
+            -O ${ARG_SPIRV_OPTIMIZATION}
             ${TARGET_TRIPLE_ARG}
             ${FEATURES_ARG}
+            ${REORDER_FIELDS_ARG}
             ${ABS_SOURCES}
     DEPENDS ${ABS_SOURCES} tc
     WORKING_DIRECTORY ${CMAKE_SOURCE_DIR}
@@ -33,21 +33,39 @@ class Device {
   Device();
  ~Device();
   GetQueue() : *Queue;
+  GetCacheHits() : uint;
+  GetCacheMisses() : uint;
 }
 
 class CommandEncoder;
 
+class Atomic<T> {
+  Load() readonly : T;
+  Store(value : T);
+  Add(value : T) : T;
+  Min(value : T) : T;
+  Max(value : T) : T;
+  And(value : T) : T;
+  Or(value : T) : T;
+  Xor(value : T) : T;
+  Exchange(value : T) : T;
+  CompareExchange(comparator : T, value : T) : T;
+}
+
 class Buffer<T> {
   Buffer(device : &Device, size : uint = 1u);
   Buffer(device : &Device, t : &T);
  ~Buffer();
   Set(data : &T);
+  SetRange(offset : uint, data : &T);
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<T>);
+  MapWrite() hostwriteable : *writeonly T;
   deviceonly MapRead() uniform : *readonly uniform T;
   deviceonly MapWrite() writeonly storage : *writeonly storage T;
   deviceonly Map() storage : *storage T;
   MapRead() hostreadable : *readonly T;
-  MapWrite() hostwriteable : *writeonly T;
+  MapReadAsync() hostreadable;
+  IsMapped() : bool;
 }
 
 class DepthStencilState {
@@ -94,14 +112,21 @@ class BlendState {
   var alpha : BlendComponent;
 }
 
+class PipelineConstant {
+  var id : uint;
+  var value : double;
+}
+
 class RenderPipeline<T> {
-  RenderPipeline(device : &Device, primitiveTopology = PrimitiveTopology.TriangleList, frontFace = FrontFace.CCW, cullMode = CullMode.None, depthStencilState : &DepthStencilState = {}, blendState : &BlendState = {});
+  RenderPipeline(device : &Device, primitiveTopology = PrimitiveTopology.TriangleList, frontFace = FrontFace.CCW, cullMode = CullMode.None, depthStencilState : &DepthStencilState = {}, blendState : &BlendState = {}, async = false, constants : *[]PipelineConstant = null);
  ~RenderPipeline();
+  IsReady() : bool;
 }
 
 class ComputePipeline<T> {
-  ComputePipeline(device : &Device);
+  ComputePipeline(device : &Device, async = false, constants : *[]PipelineConstant = null);
  ~ComputePipeline();
+  IsReady() : bool;
 }
 
 class BindGroup<T> {
@@ -186,6 +211,8 @@ class Texture1D<PF> {
   GetSize(mipLevel = 0u) : uint;
   CreateSampleableView(baseMipLevel = 0u, mipLevelCount = 0u) sampleable : *SampleableTexture1D<PF:DeviceType>;
   CreateStorageView(mipLevel = 0u) : *storage Texture1D<PF>;
+  deviceonly Load(coord : uint) readonly storage : PF:DeviceType<4>;
+  deviceonly Store(coord : uint, value : PF:DeviceType<4>) writeonly storage;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, width : uint, origin = 0u, mipLevel = 0u);
 }
 
@@ -197,6 +224,8 @@ class Texture2D<PF> {
   CreateSampleableView(baseMipLevel = 0u, mipLevelCount = 0u) sampleable : *SampleableTexture2D<PF:DeviceType>;
   CreateRenderableView(mipLevel = 0u) : *renderable Texture2D<PF>;
   CreateStorageView(mipLevel = 0u) : *storage Texture2D<PF>;
+  deviceonly Load(coord : uint<2>) readonly storage : PF:DeviceType<4>;
+  deviceonly Store(coord : uint<2>, value : PF:DeviceType<4>) writeonly storage;
   CreateColorOutput(loadOp = LoadOp.Load, storeOp = StoreOp.Store, clearValue = float<4>(0.0, 0.0, 0.0, 0.0)) renderable : *ColorOutput<PF>;
   CreateDepthStencilOutput(depthLoadOp = LoadOp.Load, depthStoreOp = StoreOp.Store, depthClearValue = 1.0, stencilLoadOp = LoadOp.Undefined, stencilStoreOp = StoreOp.Undefined, stencilClearValue = 0) renderable : *DepthStencilOutput<PF>;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, size : uint<2>, origin = uint<2>{0, 0}, mipLevel = 0u);
@@ -210,7 +239,9 @@ class Texture2DArray<PF> {
   MinBufferWidth() : uint;
   CreateSampleableView(baseMipLevel = 0u, mipLevelCount = 0u, baseArrayLayer = 0u, arrayLayerCount = 0u) sampleable : *SampleableTexture2DArray<PF:DeviceType>;
   CreateRenderableView(layee : uint, mipLevel = 0u) : *renderable Texture2D<PF>;
-  CreateStorageView(layer : uint, mipLevel = 0u) : *storage Texture2DArray<PF>;
+  CreateStorageView(baseLayer : uint, mipLevel = 0u) : *storage Texture2DArray<PF>;
+  deviceonly Load(coord : uint<2>, layer : uint) readonly storage : PF:DeviceType<4>;
+  deviceonly Store(coord : uint<2>, layer : uint, value : PF:DeviceType<4>) writeonly storage;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, size : uint<2>, layer : uint, numLayers = 1u, origin = uint<2>{0, 0}, mipLevel = 0u);
 }
 
@@ -221,7 +252,9 @@ class Texture3D<PF> {
   MinBufferWidth() : uint;
   CreateSampleableView(baseMipLevel = 0u, mipLevelCount = 0u) sampleable : *SampleableTexture3D<PF:DeviceType>;
   CreateRenderableView(depth : uint, mipLevel = 0u) : *renderable Texture2D<PF>;
-  CreateStorageView(depth : uint, mipLevel = 0u) : *storage Texture3D<PF>;
+  CreateStorageView(mipLevel = 0u) : *storage Texture3D<PF>;
+  deviceonly Load(coord : uint<3>) readonly storage : PF:DeviceType<4>;
+  deviceonly Store(coord : uint<3>, value : PF:DeviceType<4>) writeonly storage;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, size : uint<3>, origin = uint<3>{0, 0, 0}, mipLevel = 0u);
 }
 
@@ -232,7 +265,7 @@ class TextureCube<PF> {
   MinBufferWidth() : uint;
   CreateSampleableView(baseMipLevel = 0u, mipLevelCount = 0u) sampleable : *SampleableTextureCube<PF:DeviceType>;
   CreateRenderableView(face : uint, mipLevel = 0u) : *renderable Texture2D<PF>;
-  CreateStorageView(face : uint, mipLevel = 0u) : *storage TextureCube<PF>;
+  CreateStorageView(face : uint, mipLevel = 0u) : *storage Texture2D<PF>;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, size : uint<2>, face : uint, numFaces = 1u, origin = uint<2>{0, 0}, mipLevel = 0u);
 }
 
@@ -242,27 +275,75 @@ class CommandEncoder {
   Finish() : *CommandBuffer;
 }
 
+class PassTimestampWrites {
+ ~PassTimestampWrites();
+}
+
+class QuerySet {
+  QuerySet(device : &Device, count : uint);
+ ~QuerySet();
+  GetCount() : uint;
+  CreateTimestampWrites(beginIndex : uint, endIndex : uint) : *PassTimestampWrites;
+  Resolve(encoder : &CommandEncoder);
+  ReadAsync();
+  IsReady() : bool;
+  GetElapsed(beginIndex : uint, endIndex : uint) : double;
+}
+
 class RenderPass<T> {
   RenderPass(encoder : &CommandEncoder, data : &T);
+  RenderPass(encoder : &CommandEncoder, data : &T, timestampWrites : &PassTimestampWrites);
   RenderPass(base : &RenderPass<T:BaseClass>);
  ~RenderPass();
   Draw(vertexCount : uint, instanceCount : uint, firstVertex : uint, firstInstance : uint);
   DrawIndexed(indexCount : uint, instanceCount : uint, firstIndex : uint, baseVertex : uint, firstIntance : uint);
+  DrawIndirect(indirectBuffer : &indirect Buffer<[]uint>, offset = 0u);
+  DrawIndexedIndirect(indirectBuffer : &indirect Buffer<[]uint>, offset = 0u);
   SetPipeline(pipeline : &RenderPipeline<T>);
   Set(data : &T);
+  SetDynamic(data : &T, elementIndices : &[]uint);
+  ExecuteBundle(bundle : &RenderBundle<T>);
   End();
 }
 
+class RenderBundle<T> {
+  RenderBundle(device : &Device, data : &T);
+ ~RenderBundle();
+  Draw(vertexCount : uint, instanceCount : uint, firstVertex : uint, firstInstance : uint);
+  DrawIndexed(indexCount : uint, instanceCount : uint, firstIndex : uint, baseVertex : uint, firstIntance : uint);
+  DrawIndirect(indirectBuffer : &indirect Buffer<[]uint>, offset = 0u);
+  DrawIndexedIndirect(indirectBuffer : &indirect Buffer<[]uint>, offset = 0u);
+  SetPipeline(pipeline : &RenderPipeline<T>);
+  Set(data : &T);
+  Finish();
+}
+
 class ComputePass<T> {
   ComputePass(encoder : &CommandEncoder, data : &T);
+  ComputePass(encoder : &CommandEncoder, data : &T, timestampWrites : &PassTimestampWrites);
   ComputePass(base : &ComputePass<T:BaseClass>);
  ~ComputePass();
   Dispatch(workgroupCountX : uint, workgroupCountY : uint, workgroupCountZ : uint);
+  DispatchIndirect(indirectBuffer : &indirect Buffer<[]uint>, offset = 0u);
   SetPipeline(pipeline : &ComputePipeline<T>);
   Set(data : &T);
+  SetDynamic(data : &T, elementIndices : &[]uint);
   End();
 }
 
+class Profiler {
+  Profiler(device : &Device, maxPasses = 32u);
+ ~Profiler();
+  IsSupported() : bool;
+  Timestamps(name : &[]ubyte) : *PassTimestampWrites;
+  Resolve(encoder : &CommandEncoder);
+  ReadAsync();
+  Update() : bool;
+  GetDuration(name : &[]ubyte) : double;
+  GetEventCount() : uint;
+  WriteTrace(path : &[]ubyte) : bool;
+}
+
 class Window {
   Window(size : uint<2>, position = int<2>(0, 0));
   GetSize() : uint<2>;
@@ -359,6 +440,29 @@ class Math {
   static transpose(m : float<4,4>) : float<4,4>;
 }
 
+class Subgroup {
+ ~Subgroup();
+  static IsSupported(device : &Device) : bool;
+  static deviceonly InvocationId() : uint;
+  static deviceonly Size() : uint;
+  static deviceonly Add(value : int) : int;
+  static deviceonly Add(value : uint) : uint;
+  static deviceonly Add(value : float) : float;
+  static deviceonly InclusiveAdd(value : int) : int;
+  static deviceonly InclusiveAdd(value : uint) : uint;
+  static deviceonly InclusiveAdd(value : float) : float;
+  static deviceonly ExclusiveAdd(value : int) : int;
+  static deviceonly ExclusiveAdd(value : uint) : uint;
+  static deviceonly ExclusiveAdd(value : float) : float;
+  static deviceonly Broadcast(value : int, id : uint) : int;
+  static deviceonly Broadcast(value : uint, id : uint) : uint;
+  static deviceonly Broadcast(value : float, id : uint) : float;
+  static deviceonly Shuffle(value : int, id : uint) : int;
+  static deviceonly Shuffle(value : uint, id : uint) : uint;
+  static deviceonly Shuffle(value : float, id : uint) : float;
+  static deviceonly Ballot(predicate : bool) : uint<4>;
+}
+
 class Image<PF> {
   Image(encodedImage : *[]ubyte);
  ~Image();
@@ -384,9 +488,11 @@ class System {
  ~System();
   static IsRunning() : bool;
   static HasPendingEvents() : bool;
+  static ProcessEvents();
   static GetNextEvent() : *Event;
   static GetScreenSize() : uint<2>;
   static StorageBarrier() : int;
+  static WorkgroupBarrier() : int;
   static GetCurrentTime() : double;
   static Print(str : &[]ubyte);
   static PrintLine(str : &[]ubyte);
@@ -18,6 +18,7 @@
 #include <android_native_app_glue.h>
 
 #include <cassert>
+#include <string>
 
 #include <webgpu/webgpu_cpp.h>
 
@@ -92,7 +93,8 @@ Device* Device_Device() {
     }
   );
 
-  wgpu::Device device = CreateDawnDevice(wgpu::BackendType::Vulkan, &desc);
+  std::string cacheDir = std::string(gAndroidApp->activity->internalDataPath) + "/pipeline_cache";
+  wgpu::Device device = CreateDawnDevice(wgpu::BackendType::Vulkan, &desc, cacheDir.c_str());
   if (!device) { return nullptr; }
   return new Device(device);
 }
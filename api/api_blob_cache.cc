@@ -0,0 +1,156 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <api.h>  // generated by generate_bindings
+
+#include <stdio.h>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "api_internal.h"
+
+// Each entry file holds a 64-bit key size, the key itself and then the value.  The key is
+// stored so that hash collisions are detected rather than returning another entry's data.
+
+namespace Toucan {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kEntryExtension[] = ".bin";
+
+uint64_t HashKey(const void* key, size_t keySize) {
+  auto     bytes = static_cast<const uint8_t*>(key);
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < keySize; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+}  // namespace
+
+BlobCache::BlobCache(const std::string& d, uint64_t m) : dir(d), maxSize(m) {
+  std::error_code ec;
+  fs::create_directories(dir, ec);
+  for (auto& entry : fs::directory_iterator(dir, ec)) {
+    if (entry.path().extension() == kEntryExtension) { totalSize += entry.file_size(ec); }
+  }
+}
+
+fs::path BlobCache::PathFor(const void* key, size_t keySize) const {
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx%s",
+           static_cast<unsigned long long>(HashKey(key, keySize)), kEntryExtension);
+  return dir / name;
+}
+
+size_t BlobCache::Load(const void* key, size_t keySize, void* value, size_t valueSize) {
+  std::lock_guard<std::mutex> lock(mutex);
+  fs::path path = PathFor(key, keySize);
+  FILE*    f = fopen(path.string().c_str(), "rb");
+  if (!f) return 0;
+
+  size_t               result = 0;
+  uint64_t             storedKeySize;
+  std::vector<uint8_t> storedKey(keySize);
+  if (fread(&storedKeySize, sizeof(storedKeySize), 1, f) == 1 && storedKeySize == keySize &&
+      fread(storedKey.data(), 1, keySize, f) == keySize &&
+      memcmp(storedKey.data(), key, keySize) == 0) {
+    long start = ftell(f);
+    fseek(f, 0, SEEK_END);
+    size_t size = static_cast<size_t>(ftell(f) - start);
+    if (!value || valueSize == 0) {
+      // Dawn asks for the size first, then calls again with a buffer of that size.
+      result = size;
+    } else if (valueSize >= size) {
+      fseek(f, start, SEEK_SET);
+      if (fread(value, 1, size, f) == size) { result = size; }
+    }
+  }
+  fclose(f);
+  if (result > 0 && value) {
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+  }
+  return result;
+}
+
+void BlobCache::Store(const void* key, size_t keySize, const void* value, size_t valueSize) {
+  uint64_t entrySize = sizeof(uint64_t) + keySize + valueSize;
+  if (entrySize > maxSize) return;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::error_code             ec;
+  fs::path                    path = PathFor(key, keySize);
+  uint64_t                    oldSize = fs::file_size(path, ec);
+  if (!ec && fs::remove(path, ec)) { totalSize -= std::min(oldSize, totalSize); }
+  if (totalSize + entrySize > maxSize) { Evict(maxSize - entrySize); }
+
+  // Write to a temporary file and rename it into place, so that a concurrent reader in another
+  // process never sees a partial entry.  The temporary name includes the process ID, so that
+  // processes storing the same entry at once don't write into each other's files.
+  fs::path tmpPath = path;
+  tmpPath += "." + std::to_string(getpid()) + ".tmp";
+  FILE* f = fopen(tmpPath.string().c_str(), "wb");
+  if (!f) return;
+  uint64_t storedKeySize = keySize;
+  bool     ok = fwrite(&storedKeySize, sizeof(storedKeySize), 1, f) == 1 &&
+            fwrite(key, 1, keySize, f) == keySize && fwrite(value, 1, valueSize, f) == valueSize;
+  ok = fclose(f) == 0 && ok;
+  if (ok) { fs::rename(tmpPath, path, ec); }
+  if (!ok || ec) {
+    fs::remove(tmpPath, ec);
+    return;
+  }
+  totalSize += entrySize;
+}
+
+// Removes the least recently used entries until the cache holds at most targetSize bytes.
+// Called with the mutex held.
+void BlobCache::Evict(uint64_t targetSize) {
+  struct Entry {
+    fs::path           path;
+    fs::file_time_type time;
+    uint64_t           size;
+  };
+  std::vector<Entry> entries;
+  std::error_code    ec;
+  totalSize = 0;
+  for (auto& entry : fs::directory_iterator(dir, ec)) {
+    if (entry.path().extension() != kEntryExtension) continue;
+    uint64_t size = entry.file_size(ec);
+    if (ec) continue;
+    entries.push_back({entry.path(), entry.last_write_time(ec), size});
+    totalSize += size;
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.time < b.time; });
+  for (auto& entry : entries) {
+    if (totalSize <= targetSize) break;
+    if (fs::remove(entry.path, ec)) { totalSize -= entry.size; }
+  }
+}
+
+};  // namespace Toucan
@@ -21,8 +21,13 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 
+#include <algorithm>
 #include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
 
 #ifdef __EMSCRIPTEN__
@@ -45,16 +50,52 @@ bool exitOnAbort;
 
 namespace {
 
+// Default cap on the on-disk pipeline cache, overridable with TOUCAN_PIPELINE_CACHE_MAX_MB.
+constexpr uint64_t kDefaultPipelineCacheMaxMB = 256;
+
 wgpu::Instance gInstance;
+#ifndef __EMSCRIPTEN__
+std::unique_ptr<BlobCache> gBlobCache;
+#endif
 std::unordered_map<void*, wgpu::Buffer> gMappedBuffers;
 
 uint32_t BytesPerPixel(wgpu::TextureFormat format) {
   switch (format) {
+    case wgpu::TextureFormat::R8Unorm:
+    case wgpu::TextureFormat::R8Snorm:
+    case wgpu::TextureFormat::R8Uint:
+    case wgpu::TextureFormat::R8Sint: return 1;
+    case wgpu::TextureFormat::RG8Unorm:
+    case wgpu::TextureFormat::RG8Snorm:
+    case wgpu::TextureFormat::RG8Uint:
+    case wgpu::TextureFormat::RG8Sint:
+    case wgpu::TextureFormat::R16Uint:
+    case wgpu::TextureFormat::R16Sint:
+    case wgpu::TextureFormat::R16Float: return 2;
     case wgpu::TextureFormat::RGBA8Unorm:
+    case wgpu::TextureFormat::RGBA8UnormSrgb:
     case wgpu::TextureFormat::RGBA8Snorm:
     case wgpu::TextureFormat::RGBA8Uint:
     case wgpu::TextureFormat::RGBA8Sint:
-    case wgpu::TextureFormat::BGRA8Unorm: return 4;
+    case wgpu::TextureFormat::BGRA8Unorm:
+    case wgpu::TextureFormat::BGRA8UnormSrgb:
+    case wgpu::TextureFormat::RG16Uint:
+    case wgpu::TextureFormat::RG16Sint:
+    case wgpu::TextureFormat::RG16Float:
+    case wgpu::TextureFormat::R32Uint:
+    case wgpu::TextureFormat::R32Sint:
+    case wgpu::TextureFormat::R32Float:
+    case wgpu::TextureFormat::RGB10A2Unorm:
+    case wgpu::TextureFormat::RG11B10Ufloat: return 4;
+    case wgpu::TextureFormat::RGBA16Uint:
+    case wgpu::TextureFormat::RGBA16Sint:
+    case wgpu::TextureFormat::RGBA16Float:
+    case wgpu::TextureFormat::RG32Uint:
+    case wgpu::TextureFormat::RG32Sint:
+    case wgpu::TextureFormat::RG32Float: return 8;
+    case wgpu::TextureFormat::RGBA32Uint:
+    case wgpu::TextureFormat::RGBA32Sint:
+    case wgpu::TextureFormat::RGBA32Float: return 16;
     default: assert(!"unknown Format"); return 0;
   }
 }
@@ -93,7 +134,63 @@ void UnmapBuffer(void* This) {
 
 }  // namespace
 
-struct TextureView {
+// Bind groups created from identical contents are shared.  The key is the bind group's class
+// type followed by the addresses of the bound native objects.  An entry is evicted when any of
+// those objects is destroyed, since its address may then be reused.
+struct BindGroupCache {
+  struct Entry {
+    wgpu::BindGroup          bindGroup;
+    std::vector<const void*> resources;
+  };
+
+  void Evict(const void* resource) {
+    // Copy the keys out first, since erasing other resources' keys can invalidate the range.
+    std::vector<std::string> keys;
+    auto                     range = keysByResource.equal_range(resource);
+    for (auto it = range.first; it != range.second; ++it) { keys.push_back(it->second); }
+    keysByResource.erase(resource);
+    for (const auto& key : keys) {
+      auto entry = entries.find(key);
+      if (entry == entries.end()) { continue; }
+      for (const void* other : entry->second.resources) {
+        if (other != resource) { EraseKey(other, key); }
+      }
+      entries.erase(entry);
+    }
+  }
+
+  void EraseKey(const void* resource, const std::string& key) {
+    auto range = keysByResource.equal_range(resource);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == key) {
+        keysByResource.erase(it);
+        return;
+      }
+    }
+  }
+
+  std::unordered_map<std::string, Entry>            entries;
+  std::unordered_multimap<const void*, std::string> keysByResource;
+};
+
+// Base of the native objects which can be bound in a bind group.  Records the caches holding
+// bind groups which refer to this object, so that it can evict them when it is destroyed.
+struct BindableResource {
+  ~BindableResource() {
+    for (auto& weakCache : bindGroupCaches) {
+      if (auto cache = weakCache.lock()) { cache->Evict(this); }
+    }
+  }
+  void AddBindGroupCache(const std::shared_ptr<BindGroupCache>& cache) {
+    for (auto& weakCache : bindGroupCaches) {
+      if (weakCache.lock() == cache) { return; }
+    }
+    bindGroupCaches.push_back(cache);
+  }
+  std::vector<std::weak_ptr<BindGroupCache>> bindGroupCaches;
+};
+
+struct TextureView : public BindableResource {
   TextureView(wgpu::TextureView v) : view(v) {}
   wgpu::TextureView view;
 };
@@ -114,7 +211,7 @@ struct SampleableTextureCube : public TextureView {
   using TextureView::TextureView;
 };
 
-struct Texture {
+struct Texture : public BindableResource {
   Texture(wgpu::Texture t, wgpu::TextureView v) : texture(t), view(v) {}
   Texture(int                    qualifiers,
           Type*                  pixelFormat,
@@ -216,55 +313,279 @@ struct TextureCube : public Texture {
   }
 };
 
-struct Sampler {
+struct Sampler : public BindableResource {
   Sampler(wgpu::Sampler s) : sampler(s) {}
   wgpu::Sampler sampler;
 };
 
-struct Buffer {
-  Buffer(wgpu::Device d, wgpu::Buffer b, int l, int s, Type* t)
-      : device(d), buffer(b), length(l), sizeInBytes(s), type(t) {}
-  wgpu::Device device;
+// Sends an error detected outside of Dawn to the device's uncaptured error callback, where
+// Dawn's own validation errors go.
+static void ReportError(const wgpu::Device& device, wgpu::StringView message) {
+  device.InjectError(wgpu::ErrorType::Validation, message);
+}
+
+// Buffer uploads are written into persistently-mapped MapWrite chunks and recorded as
+// copies. The copies are encoded into one command buffer just ahead of the next submit.
+// Each chunk is remapped after that submit and reused once the map completes, so steady-state
+// frames neither allocate nor issue a queue write per buffer.
+struct StagingRing {
+  static constexpr uint64_t kChunkSize = 1 << 20;
+
+  struct Chunk {
+    wgpu::Buffer         buffer;
+    uint64_t             size;
+    uint64_t             used = 0;
+    uint8_t*             ptr = nullptr;  // null while the chunk is in flight
+    wgpu::Future         future = {};
+    wgpu::MapAsyncStatus mapStatus = wgpu::MapAsyncStatus::Error;
+  };
+
+  struct Copy {
+    wgpu::Buffer src;
+    uint64_t     srcOffset;
+    wgpu::Buffer dst;
+    uint64_t     dstOffset;
+    uint64_t     size;
+  };
+
+  StagingRing(wgpu::Device d) : device(d), queue(d.GetQueue()) {}
+
+  const wgpu::Device& GetDevice() const { return device; }
+
+  ~StagingRing() {
+    // In-flight map callbacks refer to the chunks.
+    for (Chunk* chunk : inFlight) {
+      wgpu::FutureWaitInfo waitInfo = {chunk->future};
+      gInstance.WaitAny(1, &waitInfo, UINT64_MAX);
+    }
+  }
+
+  void Write(wgpu::Buffer dst, uint64_t dstOffset, const void* data, uint64_t size) {
+    if (size > kChunkSize / 4) {
+      // Large uploads gain nothing from batching; flush first to keep them in order.
+      Flush();
+      queue.WriteBuffer(dst, dstOffset, data, size);
+      return;
+    }
+    if (!current || current->used + size > current->size) { current = Acquire(); }
+    memcpy(current->ptr + current->used, data, size);
+    copies.push_back({current->buffer, current->used, dst, dstOffset, size});
+    current->used = (current->used + size + 3) & ~3ull;
+  }
+
+  // Returns a mapped chunk outside the ring, which can be filled in place and then queued with
+  // AddUpload().  Upload chunks are shared, since their remap callbacks may outlive the owner.
+  std::shared_ptr<Chunk> CreateUploadChunk(uint64_t size) {
+    auto                   chunk = std::make_shared<Chunk>();
+    wgpu::BufferDescriptor desc;
+    desc.usage = wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc;
+    desc.size = chunk->size = size;
+    desc.mappedAtCreation = true;
+    chunk->buffer = device.CreateBuffer(&desc);
+    chunk->ptr = static_cast<uint8_t*>(chunk->buffer.GetMappedRange());
+    return chunk;
+  }
+
+  // Queues a copy of a whole upload chunk into "dst", in order with the staged writes.  The chunk
+  // is remapped once the copy is submitted; PollRemap() says when it can be filled again.
+  void AddUpload(std::shared_ptr<Chunk> chunk, wgpu::Buffer dst) {
+    chunk->buffer.Unmap();
+    chunk->ptr = nullptr;
+    copies.push_back({chunk->buffer, 0, dst, 0, chunk->size});
+    uploads.push_back(std::move(chunk));
+  }
+
+  // Completes a chunk's remap if it has finished, without blocking.  Returns false while the
+  // remap is pending.  Afterwards, "ptr" is null if the remap failed.
+  static bool PollRemap(Chunk* chunk) {
+    wgpu::FutureWaitInfo waitInfo = {chunk->future};
+    if (gInstance.WaitAny(1, &waitInfo, 0) != wgpu::WaitStatus::Success) { return false; }
+    chunk->future = {};
+    if (chunk->mapStatus == wgpu::MapAsyncStatus::Success) {
+      chunk->ptr = static_cast<uint8_t*>(chunk->buffer.GetMappedRange());
+      chunk->used = 0;
+    }
+    return true;
+  }
+
+  // Encodes and submits all pending copies, then starts remapping their chunks.
+  void Flush() {
+    if (copies.empty()) { return; }
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    for (const auto& c : copies) {
+      encoder.CopyBufferToBuffer(c.src, c.srcOffset, c.dst, c.dstOffset, c.size);
+    }
+    copies.clear();
+    for (Chunk* chunk : filled) { chunk->buffer.Unmap(); }
+    wgpu::CommandBuffer commandBuffer = encoder.Finish();
+    queue.Submit(1, &commandBuffer);
+    for (Chunk* chunk : filled) {
+      chunk->ptr = nullptr;
+      chunk->future = chunk->buffer.MapAsync(
+          wgpu::MapMode::Write, 0, chunk->size, wgpu::CallbackMode::AllowProcessEvents,
+          [chunk](wgpu::MapAsyncStatus s, wgpu::StringView) { chunk->mapStatus = s; });
+      inFlight.push_back(chunk);
+    }
+    filled.clear();
+    for (const auto& chunk : uploads) {
+      chunk->future = chunk->buffer.MapAsync(
+          wgpu::MapMode::Write, 0, chunk->size, wgpu::CallbackMode::AllowProcessEvents,
+          [chunk](wgpu::MapAsyncStatus s, wgpu::StringView) { chunk->mapStatus = s; });
+    }
+    uploads.clear();
+    current = nullptr;
+  }
+
+ private:
+  Chunk* Acquire() {
+    // Recycle any chunks whose remap has completed.
+    for (auto it = inFlight.begin(); it != inFlight.end();) {
+      Chunk* chunk = *it;
+      if (!PollRemap(chunk)) {
+        ++it;
+        continue;
+      }
+      it = inFlight.erase(it);
+      if (chunk->ptr) {
+        available.push_back(chunk);
+      } else {
+        // A chunk which failed to remap can't be reused, so free it.
+        chunk->buffer.Destroy();
+        std::erase_if(chunks, [chunk](const auto& c) { return c.get() == chunk; });
+      }
+    }
+    Chunk* chunk;
+    if (!available.empty()) {
+      chunk = available.back();
+      available.pop_back();
+    } else {
+      chunks.push_back(std::make_unique<Chunk>());
+      chunk = chunks.back().get();
+      wgpu::BufferDescriptor desc;
+      desc.usage = wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc;
+      desc.size = chunk->size = kChunkSize;
+      desc.mappedAtCreation = true;
+      chunk->buffer = device.CreateBuffer(&desc);
+      chunk->ptr = static_cast<uint8_t*>(chunk->buffer.GetMappedRange());
+    }
+    filled.push_back(chunk);
+    return chunk;
+  }
+
+  wgpu::Device                        device;
+  wgpu::Queue                         queue;
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  std::vector<Chunk*>                 available;
+  std::vector<Chunk*>                 filled;
+  std::vector<Chunk*>                 inFlight;
+  std::vector<Copy>                   copies;
+  std::vector<std::shared_ptr<Chunk>> uploads;  // to be remapped after the next submit
+  Chunk*                              current = nullptr;
+};
+
+static std::shared_ptr<StagingRing> GetStagingRing(Device* device) {
+  if (!device->staging) { device->staging = std::make_shared<StagingRing>(device->device); }
+  return device->staging;
+}
+
+struct Buffer : public BindableResource {
+  Buffer(std::shared_ptr<StagingRing> r, wgpu::Buffer b, int l, int s, Type* t)
+      : staging(r), buffer(b), length(l), sizeInBytes(s), type(t) {}
+  std::shared_ptr<StagingRing> staging;
   wgpu::Buffer buffer;
   int          length;
   int          sizeInBytes;
   Type*        type;
+  uint32_t     dynamicStride = 0;  // element stride of a "dynamic" buffer, else 0
   Object       mappedObject = {nullptr, nullptr};
+  // A hostwriteable device buffer's MapWrite() views point into one of its "uploads", which is
+  // copied into the buffer when released.  The buffer itself is never mapped, so it is always
+  // usable.  "upload" is the chunk most recently handed out; its view is outstanding while it
+  // is still mapped.
+  std::vector<std::shared_ptr<StagingRing::Chunk>> uploads;
+  StagingRing::Chunk*                              upload = nullptr;
+  // Set while a MapAsync issued by StartMap() has not yet been consumed by MapSync().
+  wgpu::Future         mapFuture = {};
+  wgpu::MapMode        mapMode = wgpu::MapMode::None;
+  wgpu::MapAsyncStatus mapStatus = wgpu::MapAsyncStatus::Error;
 };
 
+// For pipelines created with async = true, "future" is pending until the backend compile
+// completes and fills in "pipeline".
 struct RenderPipeline {
   RenderPipeline(wgpu::RenderPipeline p) : pipeline(p) {}
   wgpu::RenderPipeline pipeline;
+  wgpu::Future         future = {};
 };
 
 struct ComputePipeline {
   ComputePipeline(wgpu::ComputePipeline p) : pipeline(p) {}
   wgpu::ComputePipeline pipeline;
+  wgpu::Future          future = {};
+};
+
+// Returns true once the pipeline is usable.  A zero timeout polls without blocking.
+template <typename T> static bool WaitForPipeline(T* pipeline, uint64_t timeout) {
+  if (pipeline->future.id == 0) { return true; }
+  wgpu::FutureWaitInfo waitInfo = {pipeline->future};
+  if (gInstance.WaitAny(1, &waitInfo, timeout) != wgpu::WaitStatus::Success) { return false; }
+  pipeline->future = {};
+  return true;
+}
+
+struct PixelFormatName {
+  const char*         name;
+  wgpu::TextureFormat format;
+};
+
+constexpr PixelFormatName pixelFormats[] = {
+  "R8unorm",        wgpu::TextureFormat::R8Unorm,
+  "R8snorm",        wgpu::TextureFormat::R8Snorm,
+  "R8uint",         wgpu::TextureFormat::R8Uint,
+  "R8sint",         wgpu::TextureFormat::R8Sint,
+  "RG8unorm",       wgpu::TextureFormat::RG8Unorm,
+  "RG8snorm",       wgpu::TextureFormat::RG8Snorm,
+  "RG8uint",        wgpu::TextureFormat::RG8Uint,
+  "RG8sint",        wgpu::TextureFormat::RG8Sint,
+  "RGBA8unorm",     wgpu::TextureFormat::RGBA8Unorm,
+  "RGBA8unormSRGB", wgpu::TextureFormat::RGBA8UnormSrgb,
+  "RGBA8snorm",     wgpu::TextureFormat::RGBA8Snorm,
+  "RGBA8uint",      wgpu::TextureFormat::RGBA8Uint,
+  "RGBA8sint",      wgpu::TextureFormat::RGBA8Sint,
+  "BGRA8unorm",     wgpu::TextureFormat::BGRA8Unorm,
+  "BGRA8unormSRGB", wgpu::TextureFormat::BGRA8UnormSrgb,
+  "R16uint",        wgpu::TextureFormat::R16Uint,
+  "R16sint",        wgpu::TextureFormat::R16Sint,
+  "R16float",       wgpu::TextureFormat::R16Float,
+  "RG16uint",       wgpu::TextureFormat::RG16Uint,
+  "RG16sint",       wgpu::TextureFormat::RG16Sint,
+  "RG16float",      wgpu::TextureFormat::RG16Float,
+  "RGBA16uint",     wgpu::TextureFormat::RGBA16Uint,
+  "RGBA16sint",     wgpu::TextureFormat::RGBA16Sint,
+  "RGBA16float",    wgpu::TextureFormat::RGBA16Float,
+  "R32uint",        wgpu::TextureFormat::R32Uint,
+  "R32sint",        wgpu::TextureFormat::R32Sint,
+  "R32float",       wgpu::TextureFormat::R32Float,
+  "RG32uint",       wgpu::TextureFormat::RG32Uint,
+  "RG32sint",       wgpu::TextureFormat::RG32Sint,
+  "RG32float",      wgpu::TextureFormat::RG32Float,
+  "RGBA32uint",     wgpu::TextureFormat::RGBA32Uint,
+  "RGBA32sint",     wgpu::TextureFormat::RGBA32Sint,
+  "RGBA32float",    wgpu::TextureFormat::RGBA32Float,
+  "RGB10A2unorm",   wgpu::TextureFormat::RGB10A2Unorm,
+  "RG11B10ufloat",  wgpu::TextureFormat::RG11B10Ufloat,
+  "Depth24Plus",    wgpu::TextureFormat::Depth24Plus,
 };
 
 wgpu::TextureFormat ToDawnTextureFormat(Type* format) {
   assert(format->IsClass());
   auto classType = static_cast<ClassType*>(format);
-  if (classType->GetName() == "RGBA8unorm") {
-    return wgpu::TextureFormat::RGBA8Unorm;
-  } else if (classType->GetName() == "BGRA8unorm") {
-    return wgpu::TextureFormat::BGRA8Unorm;
-  } else if (classType->GetName() == "RGBA8snorm") {
-    return wgpu::TextureFormat::RGBA8Snorm;
-  } else if (classType->GetName() == "Depth24Plus") {
-    return wgpu::TextureFormat::Depth24Plus;
-  } else if (classType->GetName() == "PreferredPixelFormat") {
-    return GetPreferredPixelFormat();
-  } else if (classType->GetName() == "RGBA16float") {
-    return wgpu::TextureFormat::RGBA16Float;
-  } else if (classType->GetName() == "RG16float") {
-    return wgpu::TextureFormat::RG16Float;
-  } else if (classType->GetName() == "R16float") {
-    return wgpu::TextureFormat::R16Float;
-  } else {
-    assert(!"unknown Format");
-    return wgpu::TextureFormat::RGBA8Unorm;
+  if (classType->GetName() == "PreferredPixelFormat") { return GetPreferredPixelFormat(); }
+  for (const auto& f : pixelFormats) {
+    if (classType->GetName() == f.name) { return f.format; }
   }
+  assert(!"unknown Format");
+  return wgpu::TextureFormat::RGBA8Unorm;
 }
 
 wgpu::TextureSampleType ToDawnTextureSampleType(ClassType* type, int qualifiers) {
@@ -397,6 +718,22 @@ static wgpu::BlendState toDawnBlendState(BlendState state) {
   return wgpu::BlendState{ toDawnBlendComponent(state.color), toDawnBlendComponent(state.alpha)};
 }
 
+// "dynamic" buffers hold an array of T, each element aligned so that it can be bound with a
+// dynamic offset.  256 is the largest min{Uniform,Storage}BufferOffsetAlignment WebGPU allows.
+constexpr uint32_t kDynamicOffsetAlignment = 256;
+
+static uint32_t GetDynamicStride(Type* type) {
+  uint32_t size = type->GetSizeInBytes();
+  return (size + kDynamicOffsetAlignment - 1) / kDynamicOffsetAlignment * kDynamicOffsetAlignment;
+}
+
+static bool IsHostWriteableDeviceBuffer(int qualifiers) {
+  return (qualifiers & Type::Qualifier::HostWriteable) &&
+         (qualifiers & (Type::Qualifier::Index | Type::Qualifier::Vertex |
+                        Type::Qualifier::Uniform | Type::Qualifier::Storage |
+                        Type::Qualifier::Indirect));
+}
+
 // FIXME: this should handle a mask, properly
 static wgpu::BufferUsage toDawnBufferUsage(int qualifiers) {
   wgpu::BufferUsage result = wgpu::BufferUsage::None;
@@ -417,7 +754,13 @@ static wgpu::BufferUsage toDawnBufferUsage(int qualifiers) {
     result |= wgpu::BufferUsage::Storage;
     gpu = true;
   }
+  if (qualifiers & Type::Qualifier::Indirect) {
+    result |= wgpu::BufferUsage::Indirect;
+    gpu = true;
+  }
   if (gpu) {
+    // A hostwriteable device buffer is written through an upload buffer, so it needs no map
+    // usage of its own.
     result |= wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
   } else {
     if (qualifiers & (Type::Qualifier::HostReadable)) {
@@ -506,8 +849,25 @@ wgpu::BufferBindingType toDawnBufferBindingType(int qualifiers) {
 #endif
 }
 
-// FIXME: store this in Device.
-std::unordered_map<Type*, wgpu::BindGroupLayout> bindGroupLayoutCache;
+static bool IsStorageTexture(NativeClass templ) {
+  return templ == NativeClass::Texture1D || templ == NativeClass::Texture2D ||
+         templ == NativeClass::Texture2DArray || templ == NativeClass::Texture3D;
+}
+
+static wgpu::StorageTextureAccess ToDawnStorageTextureAccess(int qualifiers) {
+  if (qualifiers & Type::Qualifier::ReadOnly) { return wgpu::StorageTextureAccess::ReadOnly; }
+  if (qualifiers & Type::Qualifier::WriteOnly) { return wgpu::StorageTextureAccess::WriteOnly; }
+  return wgpu::StorageTextureAccess::ReadWrite;
+}
+
+static wgpu::TextureViewDimension ToDawnStorageViewDimension(NativeClass templ) {
+  switch (templ) {
+    case NativeClass::Texture1D: return wgpu::TextureViewDimension::e1D;
+    case NativeClass::Texture2DArray: return wgpu::TextureViewDimension::e2DArray;
+    case NativeClass::Texture3D: return wgpu::TextureViewDimension::e3D;
+    default: return wgpu::TextureViewDimension::e2D;
+  }
+}
 
 static wgpu::BindGroupLayoutEntry CreateBindGroupLayoutEntry(uint32_t binding,
                                                              Type*    type,
@@ -532,6 +892,7 @@ static wgpu::BindGroupLayoutEntry CreateBindGroupLayoutEntry(uint32_t binding,
   assert(templ != NativeClass::None);
   if (templ == NativeClass::Buffer) {
     entry.buffer.type = toDawnBufferBindingType(qualifiers);
+    entry.buffer.hasDynamicOffset = (qualifiers & Type::Qualifier::Dynamic) != 0;
   } else if (templ == NativeClass::SampleableTexture1D) {
     entry.texture.sampleType = ToDawnTextureSampleType(classType, qualifiers);
     entry.texture.viewDimension = wgpu::TextureViewDimension::e1D;
@@ -547,6 +908,10 @@ static wgpu::BindGroupLayoutEntry CreateBindGroupLayoutEntry(uint32_t binding,
   } else if (templ == NativeClass::SampleableTextureCube) {
     entry.texture.sampleType = ToDawnTextureSampleType(classType, qualifiers);
     entry.texture.viewDimension = wgpu::TextureViewDimension::Cube;
+  } else if (IsStorageTexture(templ)) {
+    entry.storageTexture.access = ToDawnStorageTextureAccess(qualifiers);
+    entry.storageTexture.format = ToDawnTextureFormat(classType->GetTemplateArgs()[0]);
+    entry.storageTexture.viewDimension = ToDawnStorageViewDimension(templ);
   } else {
     assert(!"invalid field type in bind group");
   }
@@ -572,17 +937,21 @@ static void CreateBindGroupLayoutEntries(ClassType*
 
 static wgpu::BindGroupLayout GetOrCreateBindGroupLayout(Device* device, Type* type) {
   assert(!type->IsPtr());
-  if (auto layout = bindGroupLayoutCache[type]) { return layout; }
+  auto& layout = device->bindGroupLayouts[type];
+  if (layout) {
+    device->cacheHits++;
+    return layout;
+  }
+  device->cacheMisses++;
   int qualifiers;
-  type = type->GetUnqualifiedType(&qualifiers);
+  Type* unqualifiedType = type->GetUnqualifiedType(&qualifiers);
   std::vector<wgpu::BindGroupLayoutEntry> entries;
-  assert(type->IsClass());
-  CreateBindGroupLayoutEntries(static_cast<ClassType*>(type), qualifiers, &entries);
+  assert(unqualifiedType->IsClass());
+  CreateBindGroupLayoutEntries(static_cast<ClassType*>(unqualifiedType), qualifiers, &entries);
   wgpu::BindGroupLayoutDescriptor desc;
   desc.entryCount = entries.size();
   desc.entries = entries.data();
-  auto layout = device->device.CreateBindGroupLayout(&desc);
-  bindGroupLayoutCache[type] = layout;
+  layout = device->device.CreateBindGroupLayout(&desc);
   return layout;
 }
 
@@ -592,6 +961,8 @@ wgpu::BindGroupEntry CreateBindGroupEntry(Type* type, int binding, void* data) {
   entry.buffer = nullptr;
   entry.sampler = nullptr;
   entry.textureView = nullptr;
+  // A null field leaves the entry empty, which Dawn reports as a validation error.
+  if (!data) { return entry; }
   if (type->IsPtr()) { type = static_cast<PtrType*>(type)->GetBaseType(); }
   int qualifiers = 0;
   type = type->GetUnqualifiedType(&qualifiers);
@@ -609,10 +980,13 @@ wgpu::BindGroupEntry CreateBindGroupEntry(Type* type, int binding, void* data) {
       templ == NativeClass::SampleableTextureCube) {
     TextureView* textureView = static_cast<TextureView*>(data);
     entry.textureView = textureView->view;
+  } else if (IsStorageTexture(templ)) {
+    entry.textureView = static_cast<Texture*>(data)->view;
   } else if (templ == NativeClass::Buffer) {
     Buffer* buffer = static_cast<Buffer*>(data);
     entry.buffer = buffer->buffer;
-    entry.size = buffer->sizeInBytes;
+    // A dynamic buffer binds one element; the offset is supplied by SetDynamic().
+    entry.size = buffer->dynamicStride ? buffer->type->GetSizeInBytes() : buffer->sizeInBytes;
   } else {
     assert("!unknown BindGroup entry type");
   }
@@ -650,6 +1024,16 @@ struct RenderPass {
   Type*                   type;
 };
 
+// A bundle records into "encoder" until Finish() replaces it with "bundle".
+struct RenderBundle {
+  RenderBundle(wgpu::Device d, wgpu::RenderBundleEncoder e, Type* t)
+      : device(d), encoder(e), type(t) {}
+  wgpu::Device              device;
+  wgpu::RenderBundleEncoder encoder;
+  wgpu::RenderBundle        bundle;
+  Type*                     type;
+};
+
 struct ComputePass {
   ComputePass(wgpu::ComputePassEncoder e, Type* t) : encoder(e), type(t) {}
   wgpu::ComputePassEncoder encoder;
@@ -666,18 +1050,236 @@ struct CommandBuffer {
   wgpu::CommandBuffer commandBuffer;
 };
 
+// "querySet" is null when the device does not support timestamp queries, in which case passes
+// are created without timestamp writes.
+struct PassTimestampWrites {
+  PassTimestampWrites(wgpu::QuerySet q, uint32_t b, uint32_t e)
+      : querySet(q), beginIndex(b), endIndex(e) {}
+  template <typename T> T ToDawn() const {
+    T result;
+    result.querySet = querySet;
+    result.beginningOfPassWriteIndex = beginIndex;
+    result.endOfPassWriteIndex = endIndex;
+    return result;
+  }
+  wgpu::QuerySet querySet;
+  uint32_t       beginIndex;
+  uint32_t       endIndex;
+};
+
+// Timestamps are resolved into "resolveBuffer" and copied to "readBuffer", which ReadAsync()
+// maps without blocking.  Once the map completes, Wait() copies the values out to "timestamps"
+// and unmaps the buffer, so the next Resolve() can reuse it.
+struct QuerySet {
+  QuerySet(wgpu::Device device, uint32_t c) : count(c) {
+    if (!device.HasFeature(wgpu::FeatureName::TimestampQuery) || count == 0) { return; }
+    wgpu::QuerySetDescriptor desc;
+    desc.type = wgpu::QueryType::Timestamp;
+    desc.count = count;
+    querySet = device.CreateQuerySet(&desc);
+    wgpu::BufferDescriptor bufferDesc;
+    bufferDesc.size = count * sizeof(uint64_t);
+    bufferDesc.usage = wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc;
+    resolveBuffer = device.CreateBuffer(&bufferDesc);
+    bufferDesc.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+    readBuffer = device.CreateBuffer(&bufferDesc);
+  }
+  // The map callback refers to this.
+  ~QuerySet() { Wait(UINT64_MAX); }
+
+  void Resolve(wgpu::CommandEncoder encoder, uint32_t queryCount) {
+    if (!querySet || queryCount == 0 || mapFuture.id != 0) { return; }
+    encoder.ResolveQuerySet(querySet, 0, queryCount, resolveBuffer, 0);
+    encoder.CopyBufferToBuffer(resolveBuffer, 0, readBuffer, 0, queryCount * sizeof(uint64_t));
+    resolvedCount = queryCount;
+  }
+
+  void ReadAsync() {
+    if (mapFuture.id != 0) { return; }
+    timestamps.clear();
+    if (!querySet || resolvedCount == 0) { return; }
+    mapStatus = wgpu::MapAsyncStatus::Error;
+    mapFuture = readBuffer.MapAsync(wgpu::MapMode::Read, 0, resolvedCount * sizeof(uint64_t),
+                                    wgpu::CallbackMode::AllowProcessEvents,
+                                    [this](wgpu::MapAsyncStatus s, wgpu::StringView) {
+                                      mapStatus = s;
+                                    });
+  }
+
+  // Returns true once the last ReadAsync() has completed.  A zero timeout polls without blocking.
+  bool Wait(uint64_t timeout) {
+    if (mapFuture.id == 0) { return true; }
+    wgpu::FutureWaitInfo waitInfo = {mapFuture};
+    if (gInstance.WaitAny(1, &waitInfo, timeout) != wgpu::WaitStatus::Success) { return false; }
+    mapFuture = {};
+    if (mapStatus == wgpu::MapAsyncStatus::Success) {
+      auto data = static_cast<const uint64_t*>(
+          readBuffer.GetConstMappedRange(0, resolvedCount * sizeof(uint64_t)));
+      timestamps.assign(data, data + resolvedCount);
+      readBuffer.Unmap();
+    }
+    resolvedCount = 0;
+    return true;
+  }
+
+  // Returns the time between two timestamps in milliseconds, or 0 if either is unavailable.
+  double GetElapsed(uint32_t beginIndex, uint32_t endIndex) const {
+    if (beginIndex >= timestamps.size() || endIndex >= timestamps.size()) { return 0.0; }
+    uint64_t begin = timestamps[beginIndex], end = timestamps[endIndex];
+    return end > begin ? static_cast<double>(end - begin) / 1.0e6 : 0.0;
+  }
+
+  uint32_t              count;
+  uint32_t              resolvedCount = 0;
+  wgpu::QuerySet        querySet;
+  wgpu::Buffer          resolveBuffer;
+  wgpu::Buffer          readBuffer;
+  wgpu::Future          mapFuture = {};
+  wgpu::MapAsyncStatus  mapStatus = wgpu::MapAsyncStatus::Error;
+  std::vector<uint64_t> timestamps;
+};
+
+// Times named passes using a begin/end timestamp pair per pass.  Each frame's queries go to the
+// next of kFrames query sets, so reading back one frame's results overlaps with recording the
+// following frames.  Every completed pass is kept for WriteTrace().
+struct Profiler {
+  static constexpr int kFrames = 3;
+
+  struct Frame {
+    std::unique_ptr<QuerySet> querySet;
+    std::vector<std::string>  names;
+    bool                      pending = false;
+  };
+
+  struct Event {
+    std::string name;
+    uint64_t    begin;
+    uint64_t    end;
+  };
+
+  Profiler(wgpu::Device device, uint32_t maxPasses) {
+    for (auto& frame : frames) { frame.querySet = std::make_unique<QuerySet>(device, maxPasses * 2); }
+  }
+
+  PassTimestampWrites* Timestamps(std::string name) {
+    Frame&   frame = frames[current];
+    uint32_t index = frame.names.size() * 2;
+    if (!frame.querySet->querySet || index + 1 >= frame.querySet->count) {
+      return new PassTimestampWrites(nullptr, 0, 0);
+    }
+    frame.names.push_back(std::move(name));
+    return new PassTimestampWrites(frame.querySet->querySet, index, index + 1);
+  }
+
+  void Resolve(wgpu::CommandEncoder encoder) {
+    Frame& frame = frames[current];
+    frame.querySet->Resolve(encoder, frame.names.size() * 2);
+  }
+
+  void ReadAsync() {
+    Frame& frame = frames[current];
+    frame.querySet->ReadAsync();
+    frame.pending = true;
+    current = (current + 1) % kFrames;
+    // The GPU is kFrames behind; wait for the oldest frame so its query set can be reused.
+    if (frames[current].pending) {
+      frames[current].querySet->Wait(UINT64_MAX);
+      Collect(&frames[current]);
+    }
+  }
+
+  bool Update() {
+    bool updated = false;
+    // Oldest first, so that durations end up holding the newest results.
+    for (int i = 0; i < kFrames; ++i) {
+      Frame& frame = frames[(current + i) % kFrames];
+      if (frame.pending && frame.querySet->Wait(0)) {
+        Collect(&frame);
+        updated = true;
+      }
+    }
+    return updated;
+  }
+
+  void Collect(Frame* frame) {
+    const auto& timestamps = frame->querySet->timestamps;
+    for (size_t i = 0; i < frame->names.size() && i * 2 + 1 < timestamps.size(); ++i) {
+      events.push_back({frame->names[i], timestamps[i * 2], timestamps[i * 2 + 1]});
+      durations[frame->names[i]] = frame->querySet->GetElapsed(i * 2, i * 2 + 1);
+    }
+    frame->names.clear();
+    frame->pending = false;
+  }
+
+  // Writes the collected passes in the Chrome trace event format, viewable in chrome://tracing
+  // or Perfetto.  Times are in microseconds, relative to the earliest pass.
+  bool WriteTrace(const std::string& path) const {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) { return false; }
+    uint64_t base = UINT64_MAX;
+    for (const auto& event : events) { base = std::min(base, event.begin); }
+    fprintf(f, "{\"traceEvents\":[");
+    for (size_t i = 0; i < events.size(); ++i) {
+      const Event& event = events[i];
+      std::string  name;
+      for (char c : event.name) {
+        if (static_cast<unsigned char>(c) < 0x20) {
+          // JSON strings can't contain raw control characters.
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          name += escaped;
+          continue;
+        }
+        if (c == '"' || c == '\\') { name += '\\'; }
+        name += c;
+      }
+      uint64_t duration = event.end > event.begin ? event.end - event.begin : 0;
+      fprintf(f, "%s\n{\"name\":\"%s\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+              "\"ts\":%.3f,\"dur\":%.3f}",
+              i > 0 ? "," : "", name.c_str(), (event.begin - base) / 1.0e3, duration / 1.0e3);
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+  }
+
+  Frame                                   frames[kFrames];
+  int                                     current = 0;
+  std::vector<Event>                      events;
+  std::unordered_map<std::string, double> durations;
+};
+
 struct Queue {
-  Queue(wgpu::Queue q) : queue(q) {}
-  wgpu::Queue queue;
+  Queue(wgpu::Queue q, std::shared_ptr<StagingRing> r) : queue(q), staging(r) {}
+  wgpu::Queue                  queue;
+  std::shared_ptr<StagingRing> staging;
 };
 
-Queue* Device_GetQueue(Device* device) { return new Queue(device->device.GetQueue()); }
+Queue* Device_GetQueue(Device* device) {
+  return new Queue(device->device.GetQueue(), GetStagingRing(device));
+}
+
+uint32_t Device_GetCacheHits(Device* This) { return This->cacheHits; }
 
-void Device_Destroy(Device* This) { delete This; }
+uint32_t Device_GetCacheMisses(Device* This) { return This->cacheMisses; }
+
+void Device_Destroy(Device* This) {
+  // Pending async pipeline callbacks write into this device's caches, so let them run first.
+  for (auto future : This->pendingPipelines) {
+    wgpu::FutureWaitInfo waitInfo = {future};
+    gInstance.WaitAny(1, &waitInfo, UINT64_MAX);
+  }
+  delete This;
+}
 
 void Queue_Destroy(Queue* This) { delete This; }
 
-wgpu::ShaderModule createShaderModule(Device* device, Method* m) {
+static wgpu::ShaderModule GetOrCreateShaderModule(Device* device, Method* m) {
+  auto& module = device->shaderModules[m];
+  if (module) {
+    device->cacheHits++;
+    return module;
+  }
+  device->cacheMisses++;
   wgpu::ShaderModuleDescriptor desc;
 #ifdef __EMSCRIPTEN__
   wgpu::ShaderModuleWGSLDescriptor wgslDesc;
@@ -689,7 +1291,8 @@ wgpu::ShaderModule createShaderModule(Device* device, Method* m) {
   spirvDesc.code = m->spirv.data();
   desc.nextInChain = &spirvDesc;
 #endif
-  return device->device.CreateShaderModule(&desc);
+  module = device->device.CreateShaderModule(&desc);
+  return module;
 }
 
 struct PipelineLayout {
@@ -759,31 +1362,147 @@ static void ExtractPipelineLayout(ClassType* classType, Device* device, wgpu::Bl
   }
 }
 
+static wgpu::PipelineLayout GetOrCreatePipelineLayout(Device* device, ClassType* classType,
+                                                      const PipelineLayout& pipelineLayout) {
+  auto& layout = device->pipelineLayouts[classType];
+  if (layout) {
+    device->cacheHits++;
+    return layout;
+  }
+  device->cacheMisses++;
+  wgpu::PipelineLayoutDescriptor desc;
+  desc.bindGroupLayoutCount = pipelineLayout.bindGroupLayouts.size();
+  desc.bindGroupLayouts = pipelineLayout.bindGroupLayouts.data();
+  layout = device->device.CreatePipelineLayout(&desc);
+  return layout;
+}
+
+// Only for scalars and enums: structs must append each field, since their padding is
+// uninitialized.
+template <typename T> static void AppendToKey(std::string* key, const T& value) {
+  static_assert(std::is_scalar_v<T>);
+  key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void AppendToKey(std::string* key, const BlendComponent& component) {
+  AppendToKey(key, component.operation);
+  AppendToKey(key, component.srcFactor);
+  AppendToKey(key, component.dstFactor);
+}
+
+static void AppendToKey(std::string* key, const BlendState& blendState) {
+  AppendToKey(key, blendState.color);
+  AppendToKey(key, blendState.alpha);
+}
+
+// Returns true if the shader declares the override with the given SpecId.
+static bool DeclaresOverride(Method* m, uint32_t specId) {
+#ifdef __EMSCRIPTEN__
+  return m->wgsl.find("@id(" + std::to_string(specId) + ")") != std::string::npos;
+#else
+  const uint32_t kOpDecorate = 71, kDecorationSpecId = 1;
+  // Skip the five-word header, then walk the instructions looking for SpecId decorations.
+  for (size_t i = 5; i < m->spirv.size(); i += m->spirv[i] >> 16) {
+    uint32_t op = m->spirv[i];
+    if ((op & 0xFFFF) == kOpDecorate && (op >> 16) == 4 && m->spirv[i + 2] == kDecorationSpecId &&
+        m->spirv[i + 3] == specId) {
+      return true;
+    }
+    if ((op >> 16) == 0) { break; }
+  }
+  return false;
+#endif
+}
+
+// The values given for a pipeline's overrides, keyed by SpecId.
+struct PipelineConstants {
+  explicit PipelineConstants(Object* constants) {
+    if (!constants->ptr) { return; }
+    auto     data = static_cast<const PipelineConstant*>(constants->ptr);
+    uint32_t length = constants->controlBlock->arrayLength;
+    values.assign(data, data + length);
+    for (const auto& constant : values) { keys.push_back(std::to_string(constant.id)); }
+  }
+
+  void AppendToKey(std::string* key) const {
+    for (const auto& constant : values) {
+      Toucan::AppendToKey(key, constant.id);
+      Toucan::AppendToKey(key, constant.value);
+    }
+  }
+
+  // Dawn rejects constants that a stage does not declare, so each stage only gets its own.
+  std::vector<wgpu::ConstantEntry> GetEntries(Method* m) const {
+    std::vector<wgpu::ConstantEntry> entries;
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (!DeclaresOverride(m, values[i].id)) { continue; }
+      wgpu::ConstantEntry entry;
+      entry.key = keys[i].c_str();
+      entry.value = values[i].value;
+      entries.push_back(entry);
+    }
+    return entries;
+  }
+
+  std::vector<PipelineConstant> values;
+  std::vector<std::string>      keys;
+};
+
 struct PipelineData {
   std::vector<wgpu::BindGroup>                 bindGroups;
+  std::vector<std::vector<uint32_t>>           dynamicStrides;  // per bind group
   std::vector<wgpu::RenderPassColorAttachment> colorAttachments;
   wgpu::RenderPassDepthStencilAttachment       depthStencilAttachment;
   std::vector<wgpu::Buffer>                    vertexBuffers;
   wgpu::Buffer                                 indexBuffer;
   wgpu::IndexFormat                            indexFormat;
+  const uint32_t*                              elementIndices = nullptr;
+  size_t                                       numElementIndices = 0;
 
-  void Set(wgpu::RenderPassEncoder encoder) {
+  // Every dynamic binding needs an offset, so bindings without an element index get 0.
+  template <typename T> void SetBindGroups(T encoder) {
+    size_t                next = 0;
+    std::vector<uint32_t> offsets;
     for (int i = 0; i < bindGroups.size(); i++) {
-      if (bindGroups[i]) { encoder.SetBindGroup(i, bindGroups[i]); }
+      offsets.clear();
+      for (uint32_t stride : dynamicStrides[i]) {
+        uint32_t index = next < numElementIndices ? elementIndices[next] : 0;
+        offsets.push_back(index * stride);
+        next++;
+      }
+      if (bindGroups[i]) { encoder.SetBindGroup(i, bindGroups[i], offsets.size(), offsets.data()); }
     }
+  }
+
+  // Render passes and render bundles take the same draw state.
+  template <typename T> void SetDrawState(T encoder) {
+    SetBindGroups(encoder);
     for (int i = 0; i < vertexBuffers.size(); i++) {
       if (vertexBuffers[i]) { encoder.SetVertexBuffer(i, vertexBuffers[i]); }
     }
     if (indexBuffer) { encoder.SetIndexBuffer(indexBuffer, indexFormat); }
   }
 
-  void Set(wgpu::ComputePassEncoder encoder) {
-    for (int i = 0; i < bindGroups.size(); i++) {
-      if (bindGroups[i]) { encoder.SetBindGroup(i, bindGroups[i]); }
-    }
-  }
+  void Set(wgpu::RenderPassEncoder encoder) { SetDrawState(encoder); }
+
+  void Set(wgpu::RenderBundleEncoder encoder) { SetDrawState(encoder); }
+
+  void Set(wgpu::ComputePassEncoder encoder) { SetBindGroups(encoder); }
 };
 
+// Collects the element strides of the dynamic buffers in a bind group, in binding order.
+static void GetDynamicStrides(ClassType* classType, std::vector<uint32_t>* strides) {
+  if (classType->GetParent()) { GetDynamicStrides(classType->GetParent(), strides); }
+  for (const auto& field : classType->GetFields()) {
+    assert(field->type->IsPtr());
+    int   qualifiers;
+    Type* type = static_cast<PtrType*>(field->type)->GetBaseType()->GetUnqualifiedType(&qualifiers);
+    if (!(qualifiers & Type::Qualifier::Dynamic)) { continue; }
+    assert(type->IsClass() && static_cast<ClassType*>(type)->GetTemplate() == NativeClass::Buffer);
+    strides->push_back(GetDynamicStride(static_cast<ClassType*>(type)->GetTemplateArgs()[0]));
+  }
+}
+
 static void ExtractPipelineData(Type* type, void* data, PipelineData* out) {
   assert(type->IsClass());
   auto classType = static_cast<ClassType*>(type);
@@ -814,10 +1533,24 @@ static void ExtractPipelineData(Type* type, void* data, PipelineData* out) {
     } else if (classType->GetTemplate() == NativeClass::BindGroup) {
       out->bindGroups.push_back(ptr ? static_cast<BindGroup*>(ptr)->bindGroup
                                            : nullptr);
+      out->dynamicStrides.emplace_back();
+      Type* bindGroupType = classType->GetTemplateArgs()[0];
+      assert(bindGroupType->IsClass());
+      GetDynamicStrides(static_cast<ClassType*>(bindGroupType), &out->dynamicStrides.back());
     }
   }
 }
 
+// Records an async compile for Device_Destroy() to wait on.  Finished compiles are dropped
+// first, so the list only grows with the number in flight.
+static void AddPendingPipeline(Device* device, wgpu::Future future) {
+  std::erase_if(device->pendingPipelines, [](wgpu::Future pending) {
+    wgpu::FutureWaitInfo waitInfo = {pending};
+    return gInstance.WaitAny(1, &waitInfo, 0) == wgpu::WaitStatus::Success;
+  });
+  device->pendingPipelines.push_back(future);
+}
+
 RenderPipeline* RenderPipeline_RenderPipeline(int               qualifiers,
                                               Type*             type,
                                               Device*           device,
@@ -825,20 +1558,41 @@ RenderPipeline* RenderPipeline_RenderPipeline(int               qualifiers,
                                               FrontFace         frontFace,
                                               CullMode          cullMode,
                                               DepthStencilState*depthStencil,
-                                              BlendState*       blendState) {
+                                              BlendState*       blendState,
+                                              bool              async,
+                                              Object*           constants) {
   if (!type->IsClass()) { return nullptr; }
   ClassType*         classType = static_cast<ClassType*>(type);
+  PipelineConstants  pipelineConstants(constants);
+  // The depth-stencil state is not consumed below, so it is not part of the key.
+  std::string key;
+  AppendToKey(&key, classType);
+  AppendToKey(&key, primitiveTopology);
+  AppendToKey(&key, frontFace);
+  AppendToKey(&key, cullMode);
+  AppendToKey(&key, *blendState);
+  pipelineConstants.AppendToKey(&key);
+  auto& pipeline = device->renderPipelines[key];
+  if (pipeline) {
+    device->cacheHits++;
+    return new RenderPipeline(pipeline);
+  }
+  device->cacheMisses++;
   wgpu::ShaderModule vertexShader, fragmentShader;
+  Method*            vertexMethod = nullptr;
+  Method*            fragmentMethod = nullptr;
   for (ClassType* c = classType; c != nullptr && (!vertexShader || !fragmentShader);
        c = c->GetParent()) {
     for (auto& method : c->GetMethods()) {
       if (method->modifiers & Method::Modifier::Vertex) {
         if (!vertexShader) {
-          vertexShader = createShaderModule(device, method.get());
+          vertexShader = GetOrCreateShaderModule(device, method.get());
+          vertexMethod = method.get();
         }
       } else if (method->modifiers & Method::Modifier::Fragment) {
         if (!fragmentShader) {
-          fragmentShader = createShaderModule(device, method.get());
+          fragmentShader = GetOrCreateShaderModule(device, method.get());
+          fragmentMethod = method.get();
         }
       }
     }
@@ -849,9 +1603,13 @@ RenderPipeline* RenderPipeline_RenderPipeline(int               qualifiers,
   ExtractPipelineLayout(classType, device, &dawnBlendState, &pipelineLayout);
   pipelineLayout.FinalizeVertexLayouts();
 
+  auto vertexConstants = pipelineConstants.GetEntries(vertexMethod);
+  auto fragmentConstants = pipelineConstants.GetEntries(fragmentMethod);
   wgpu::VertexState vertexState;
   vertexState.module = vertexShader;
   vertexState.entryPoint = "main";
+  vertexState.constantCount = vertexConstants.size();
+  vertexState.constants = vertexConstants.data();
   vertexState.bufferCount = pipelineLayout.vertexBufferLayouts.size();
   vertexState.buffers = pipelineLayout.vertexBufferLayouts.data();
   wgpu::RenderPipelineDescriptor rpDesc;
@@ -864,14 +1622,12 @@ RenderPipeline* RenderPipeline_RenderPipeline(int               qualifiers,
   wgpu::FragmentState fragmentState;
   fragmentState.module = fragmentShader;
   fragmentState.entryPoint = "main";
-  fragmentState.constants = nullptr;
+  fragmentState.constantCount = fragmentConstants.size();
+  fragmentState.constants = fragmentConstants.data();
   fragmentState.targetCount = pipelineLayout.colorTargets.size();
   fragmentState.targets = pipelineLayout.colorTargets.data();
   wgpu::PrimitiveState           primitiveState;
-  wgpu::PipelineLayoutDescriptor desc;
-  desc.bindGroupLayoutCount = pipelineLayout.bindGroupLayouts.size();
-  desc.bindGroupLayouts = pipelineLayout.bindGroupLayouts.data();
-  rpDesc.layout = device->device.CreatePipelineLayout(&desc);
+  rpDesc.layout = GetOrCreatePipelineLayout(device, classType, pipelineLayout);
   rpDesc.vertex = vertexState;
   rpDesc.fragment = &fragmentState;
   rpDesc.primitive.topology = toDawnPrimitiveTopology(primitiveTopology);
@@ -883,45 +1639,117 @@ RenderPipeline* RenderPipeline_RenderPipeline(int               qualifiers,
   if (pipelineLayout.depthStencilTarget.format != wgpu::TextureFormat::Undefined) {
     rpDesc.depthStencil = &depthStencilState;
   }
-  return new RenderPipeline(device->device.CreateRenderPipeline(&rpDesc));
+  if (async) {
+    // The pipeline enters the device cache once compiled; until then, a request for the same
+    // key compiles its own.  Cache entries are never erased, so "pipeline" stays valid.
+    auto result = new RenderPipeline(nullptr);
+    result->future = device->device.CreateRenderPipelineAsync(
+        &rpDesc, wgpu::CallbackMode::WaitAnyOnly,
+        [result, &pipeline, d = device->device](wgpu::CreatePipelineAsyncStatus status,
+                                                wgpu::RenderPipeline p, wgpu::StringView message) {
+          if (status != wgpu::CreatePipelineAsyncStatus::Success) {
+            // A failed async compile only reports through this callback.
+            ReportError(d, message);
+            return;
+          }
+          result->pipeline = p;
+          pipeline = p;
+        });
+    AddPendingPipeline(device, result->future);
+    return result;
+  }
+  pipeline = device->device.CreateRenderPipeline(&rpDesc);
+  return new RenderPipeline(pipeline);
 }
 
-void RenderPipeline_Destroy(RenderPipeline* This) { delete This; }
+bool RenderPipeline_IsReady(RenderPipeline* This) { return WaitForPipeline(This, 0); }
+
+void RenderPipeline_Destroy(RenderPipeline* This) {
+  WaitForPipeline(This, UINT64_MAX);
+  delete This;
+}
 
 ComputePipeline* ComputePipeline_ComputePipeline(int     qualifiers,
                                                  Type*   computeLayout,
-                                                 Device* device) {
+                                                 Device* device,
+                                                 bool    async,
+                                                 Object* constants) {
   if (!computeLayout->IsClass()) { return nullptr; }
   ClassType*         classType = static_cast<ClassType*>(computeLayout);
+  PipelineConstants  pipelineConstants(constants);
+  std::string        key;
+  AppendToKey(&key, classType);
+  pipelineConstants.AppendToKey(&key);
+  auto&              pipeline = device->computePipelines[key];
+  if (pipeline) {
+    device->cacheHits++;
+    return new ComputePipeline(pipeline);
+  }
+  device->cacheMisses++;
   wgpu::ShaderModule computeShader;
+  Method*            computeMethod = nullptr;
   for (auto& method : classType->GetMethods()) {
     if (method->modifiers & Method::Modifier::Compute) {
       if (computeShader) {
         assert(!"more than one compute shader specified");
         return nullptr;
       }
-      computeShader = createShaderModule(device, method.get());
+      computeShader = GetOrCreateShaderModule(device, method.get());
+      computeMethod = method.get();
     }
   }
+  auto computeConstants = pipelineConstants.GetEntries(computeMethod);
   wgpu::ComputeState computeState;
   computeState.module = computeShader;
   computeState.entryPoint = "main";
+  computeState.constantCount = computeConstants.size();
+  computeState.constants = computeConstants.data();
   wgpu::ComputePipelineDescriptor cpDesc;
   PipelineLayout                  pipelineLayout;
   ExtractPipelineLayout(classType, device, nullptr, &pipelineLayout);
-  wgpu::PipelineLayoutDescriptor desc;
-  desc.bindGroupLayoutCount = pipelineLayout.bindGroupLayouts.size();
-  desc.bindGroupLayouts = pipelineLayout.bindGroupLayouts.data();
-  cpDesc.layout = device->device.CreatePipelineLayout(&desc);
+  cpDesc.layout = GetOrCreatePipelineLayout(device, classType, pipelineLayout);
   cpDesc.compute = computeState;
-  return new ComputePipeline(device->device.CreateComputePipeline(&cpDesc));
+  if (async) {
+    auto result = new ComputePipeline(nullptr);
+    result->future = device->device.CreateComputePipelineAsync(
+        &cpDesc, wgpu::CallbackMode::WaitAnyOnly,
+        [result, &pipeline, d = device->device](wgpu::CreatePipelineAsyncStatus status,
+                                                wgpu::ComputePipeline p, wgpu::StringView message) {
+          if (status != wgpu::CreatePipelineAsyncStatus::Success) {
+            // A failed async compile only reports through this callback.
+            ReportError(d, message);
+            return;
+          }
+          result->pipeline = p;
+          pipeline = p;
+        });
+    AddPendingPipeline(device, result->future);
+    return result;
+  }
+  pipeline = device->device.CreateComputePipeline(&cpDesc);
+  return new ComputePipeline(pipeline);
 }
 
-void ComputePipeline_Destroy(ComputePipeline* This) { delete This; }
+bool ComputePipeline_IsReady(ComputePipeline* This) { return WaitForPipeline(This, 0); }
 
-BindGroup* BindGroup_BindGroup(int qualifiers, Type* type, Device* device, void* data) {
-  assert(type->IsClass() && "bind group argument must be a class type");
-  ClassType*                        classType = static_cast<ClassType*>(type);
+void ComputePipeline_Destroy(ComputePipeline* This) {
+  WaitForPipeline(This, UINT64_MAX);
+  delete This;
+}
+
+// Returns the native object bound by a bind group field, as the BindableResource it derives from.
+static BindableResource* ToBindableResource(Type* type, void* ptr) {
+  if (type->IsPtr()) { type = static_cast<PtrType*>(type)->GetBaseType(); }
+  type = type->GetUnqualifiedType();
+  assert(type->IsClass());
+  ClassType* c = static_cast<ClassType*>(type);
+  if (c->GetNativeClass() == NativeClass::Sampler) { return static_cast<Sampler*>(ptr); }
+  if (c->GetTemplate() == NativeClass::Buffer) { return static_cast<Buffer*>(ptr); }
+  if (IsStorageTexture(c->GetTemplate())) { return static_cast<Texture*>(ptr); }
+  return static_cast<TextureView*>(ptr);
+}
+
+static wgpu::BindGroup CreateBindGroup(Device* device, ClassType* classType, void* data) {
   wgpu::BindGroupDescriptor         desc;
   std::vector<wgpu::BindGroupEntry> entries;
   desc.entryCount = classType->GetFields().size();
@@ -932,7 +1760,44 @@ BindGroup* BindGroup_BindGroup(int qualifiers, Type* type, Device* device, void*
   }
   desc.entries = entries.data();
   desc.layout = GetOrCreateBindGroupLayout(device, classType);
-  return new BindGroup(device->device.CreateBindGroup(&desc));
+  return device->device.CreateBindGroup(&desc);
+}
+
+BindGroup* BindGroup_BindGroup(int qualifiers, Type* type, Device* device, void* data) {
+  assert(type->IsClass() && "bind group argument must be a class type");
+  ClassType*                     classType = static_cast<ClassType*>(type);
+  std::vector<BindableResource*> resources;
+  std::string                    key;
+  AppendToKey(&key, classType);
+  for (const auto& field : classType->GetFields()) {
+    Object* object = reinterpret_cast<Object*>((uint8_t*)data + field->offset);
+    if (!object->ptr) {
+      // The (invalid) bind group has nothing to evict it, so it is not cached.
+      return new BindGroup(CreateBindGroup(device, classType, data));
+    }
+    resources.push_back(ToBindableResource(field->type, object->ptr));
+    AppendToKey(&key, resources.back());
+  }
+  if (!device->bindGroupCache) { device->bindGroupCache = std::make_shared<BindGroupCache>(); }
+  auto  cache = device->bindGroupCache;
+  auto& cached = cache->entries[key];
+  if (cached.bindGroup) {
+    device->cacheHits++;
+    return new BindGroup(cached.bindGroup);
+  }
+  device->cacheMisses++;
+  cached.bindGroup = CreateBindGroup(device, classType, data);
+  for (BindableResource* resource : resources) {
+    // A resource bound twice needs only one eviction entry.
+    if (std::find(cached.resources.begin(), cached.resources.end(), resource) !=
+        cached.resources.end()) {
+      continue;
+    }
+    cached.resources.push_back(resource);
+    cache->keysByResource.emplace(resource, key);
+    resource->AddBindGroupCache(cache);
+  }
+  return new BindGroup(cached.bindGroup);
 }
 
 void BindGroup_Destroy(BindGroup* This) { delete This; }
@@ -963,7 +1828,7 @@ SampleableTexture1D* Texture1D_CreateSampleableView(Texture1D* This, uint32_t ba
 }
 
 Texture1D* Texture1D_CreateStorageView(Texture1D* This, uint32_t mipLevel) {
-  return new Texture1D(This, This->CreateView(mipLevel));
+  return new Texture1D(This, This->CreateView(mipLevel, 1));
 }
 
 void Texture1D_CopyFromBuffer(Texture1D*      dest,
@@ -991,7 +1856,7 @@ Texture2D* Texture2D_CreateRenderableView(Texture2D* This, uint32_t mipLevel) {
 }
 
 Texture2D* Texture2D_CreateStorageView(Texture2D* This, uint32_t mipLevel) {
-  return new Texture2D(This, This->CreateView(mipLevel));
+  return new Texture2D(This, This->CreateView(mipLevel, 1));
 }
 
 ColorOutput* Texture2D_CreateColorOutput(Texture2D*   This,
@@ -1076,7 +1941,7 @@ Texture2D* Texture2DArray_CreateRenderableView(Texture2DArray* This,
 Texture2DArray* Texture2DArray_CreateStorageView(Texture2DArray* This,
                                                  uint32_t        baseArrayLayer,
                                                  uint32_t        mipLevel) {
-  return new Texture2DArray(This, This->CreateView(mipLevel, 0, baseArrayLayer, 0));
+  return new Texture2DArray(This, This->CreateView(mipLevel, 1, baseArrayLayer, 0));
 }
 
 uint32_t Texture2DArray_MinBufferWidth(Texture2DArray* This) { return This->MinBufferWidth(); }
@@ -1116,8 +1981,8 @@ Texture2D* Texture3D_CreateRenderableView(Texture3D* This, uint32_t depth, uint3
   return new Texture2D(This, This->Create2DView(mipLevel, depth));
 }
 
-Texture3D* Texture3D_CreateStorageView(Texture2D* This, uint32_t baseDepth, uint32_t mipLevel) {
-  return new Texture3D(This, This->CreateView(mipLevel, 0, baseDepth, 0));
+Texture3D* Texture3D_CreateStorageView(Texture3D* This, uint32_t mipLevel) {
+  return new Texture3D(This, This->CreateView(mipLevel, 1));
 }
 
 uint32_t Texture3D_MinBufferWidth(Texture3D* This) { return This->MinBufferWidth(); }
@@ -1155,8 +2020,9 @@ Texture2D* TextureCube_CreateRenderableView(TextureCube* This, uint32_t face, ui
   return new Texture2D(This, This->Create2DView(mipLevel, face));
 }
 
-TextureCube* TextureCube_CreateStorageView(TextureCube* This, uint32_t face, uint32_t mipLevel) {
-  return new TextureCube(This, This->CreateView(mipLevel, 0, face, 0));
+// Cube views cannot be bound as storage textures, so each face is exposed as a 2D view.
+Texture2D* TextureCube_CreateStorageView(TextureCube* This, uint32_t face, uint32_t mipLevel) {
+  return new Texture2D(This, This->Create2DView(mipLevel, face));
 }
 
 uint32_t TextureCube_MinBufferWidth(TextureCube* This) { return This->MinBufferWidth(); }
@@ -1197,31 +2063,30 @@ void Buffer_CopyFromBuffer(Buffer* This, CommandEncoder* encoder, Buffer* source
   encoder->encoder.CopyBufferToBuffer(source->buffer, 0, This->buffer, 0, source->sizeInBytes);
 }
 
-static Object* MapSync(wgpu::MapMode mapMode, Buffer* buffer) {
-  if (buffer->buffer.GetMapState() == wgpu::BufferMapState::Mapped) {
-    buffer->mappedObject.controlBlock->weakRefs++;
-    buffer->mappedObject.controlBlock->strongRefs++;
-    return &buffer->mappedObject;
-  }
+static void StartMap(wgpu::MapMode mapMode, Buffer* buffer) {
+  if (buffer->mapFuture.id != 0) { return; }
+  // Land any staged writes to this buffer before it is mapped.
+  buffer->staging->Flush();
+  buffer->mapMode = mapMode;
+  buffer->mapStatus = wgpu::MapAsyncStatus::Error;
+  buffer->mapFuture = buffer->buffer.MapAsync(mapMode, 0, buffer->sizeInBytes,
+                                              wgpu::CallbackMode::AllowProcessEvents,
+                                              [buffer](wgpu::MapAsyncStatus s, wgpu::StringView) {
+                                                buffer->mapStatus = s;
+                                              });
+}
 
-  wgpu::MapAsyncStatus mapStatus = wgpu::MapAsyncStatus::Error;
-  wgpu::Future future = buffer->buffer.MapAsync(mapMode, 0, buffer->sizeInBytes, wgpu::CallbackMode::WaitAnyOnly,
-                                                [&mapStatus](wgpu::MapAsyncStatus s, wgpu::StringView) {
-                                                  mapStatus = s;
-                                                });
-  wgpu::FutureWaitInfo waitInfo = {future};
-  if (gInstance.WaitAny(1, &waitInfo, UINT64_MAX) != wgpu::WaitStatus::Success
-      || mapStatus != wgpu::MapAsyncStatus::Success) {
-    return &buffer->mappedObject;
-  }
+// Returns true once the pending map has completed.  A zero timeout polls without blocking.
+static bool WaitForMap(Buffer* buffer, uint64_t timeout) {
+  if (buffer->mapFuture.id == 0) { return true; }
+  wgpu::FutureWaitInfo waitInfo = {buffer->mapFuture};
+  return gInstance.WaitAny(1, &waitInfo, timeout) == wgpu::WaitStatus::Success;
+}
 
-  Object result;
-  if (!(mapMode & wgpu::MapMode::Write)) {
-    const void* ptr = buffer->buffer.GetConstMappedRange();
-    buffer->mappedObject.ptr = const_cast<void*>(ptr);
-  } else {
-    buffer->mappedObject.ptr = buffer->buffer.GetMappedRange();
-  }
+// Fills in the buffer's mapped object to point at ptr.  The deleter runs when the last
+// reference to it is released.
+static Object* WrapMappedRange(Buffer* buffer, void* ptr, Deleter deleter) {
+  buffer->mappedObject.ptr = ptr;
 #if defined(_WIN32) && (defined(_M_IX86) || defined(__i386__))
   ControlBlock* controlBlock =
       static_cast<ControlBlock*>(_aligned_malloc(sizeof(ControlBlock), 16));
@@ -1232,22 +2097,116 @@ static Object* MapSync(wgpu::MapMode mapMode, Buffer* buffer) {
   controlBlock->weakRefs = 1;
   controlBlock->type = buffer->type;
   controlBlock->arrayLength = buffer->length;
-  controlBlock->type = buffer->type;
-  controlBlock->deleter = &UnmapBuffer;
+  controlBlock->deleter = deleter;
   buffer->mappedObject.controlBlock = controlBlock;
-  gMappedBuffers[buffer->mappedObject.ptr] = buffer->buffer;
   return &buffer->mappedObject;
 }
 
+static Object* MapSync(wgpu::MapMode mapMode, Buffer* buffer) {
+  if (buffer->mapFuture.id == 0 &&
+      buffer->buffer.GetMapState() == wgpu::BufferMapState::Mapped) {
+    buffer->mappedObject.controlBlock->weakRefs++;
+    buffer->mappedObject.controlBlock->strongRefs++;
+    return &buffer->mappedObject;
+  }
+
+  StartMap(mapMode, buffer);
+  bool mapped =
+      WaitForMap(buffer, UINT64_MAX) && buffer->mapStatus == wgpu::MapAsyncStatus::Success;
+  buffer->mapFuture = {};
+  if (!mapped) { return &buffer->mappedObject; }
+
+  void* ptr;
+  if (!(buffer->mapMode & wgpu::MapMode::Write)) {
+    ptr = const_cast<void*>(buffer->buffer.GetConstMappedRange());
+  } else {
+    ptr = buffer->buffer.GetMappedRange();
+  }
+  gMappedBuffers[ptr] = buffer->buffer;
+  return WrapMappedRange(buffer, ptr, &UnmapBuffer);
+}
+
+struct PendingUpload {
+  std::shared_ptr<StagingRing::Chunk> chunk;
+  wgpu::Buffer                        dst;
+  std::shared_ptr<StagingRing>        staging;
+};
+
+static std::unordered_map<void*, PendingUpload> gPendingUploads;
+
+static void FinishUpload(void* This) {
+  auto it = gPendingUploads.find(This);
+  PendingUpload& upload = it->second;
+  upload.staging->AddUpload(std::move(upload.chunk), upload.dst);
+  gPendingUploads.erase(it);
+}
+
+// Returns the mapping of a hostwriteable device buffer's outstanding MapWrite() view, if any.
+static uint8_t* GetUploadMapping(Buffer* buffer) {
+  return buffer->upload ? buffer->upload->ptr : nullptr;
+}
+
+// Maps a hostwriteable device buffer for writing.  The view is in the buffer's device layout,
+// so callers fill it in place with no intermediate host copy.  Device buffers can't be mapped
+// while the GPU may use them, so views point into a small ring of upload chunks, each copied
+// into the buffer (in order with other staged writes) when its view is released.  A chunk is
+// reused only once its remap has completed; if none is ready, the ring grows rather than
+// waiting.  The view's prior contents are undefined.
+static Object* MapForUpload(Buffer* buffer) {
+  if (GetUploadMapping(buffer)) {
+    // A view is still outstanding.
+    buffer->mappedObject.controlBlock->weakRefs++;
+    buffer->mappedObject.controlBlock->strongRefs++;
+    return &buffer->mappedObject;
+  }
+  std::shared_ptr<StagingRing::Chunk> chunk;
+  for (auto it = buffer->uploads.begin(); it != buffer->uploads.end();) {
+    StagingRing::Chunk* c = it->get();
+    // A chunk whose copy has not been submitted yet has neither a mapping nor a future.
+    if (c->future.id != 0 && StagingRing::PollRemap(c) && !c->ptr) {
+      // A chunk which failed to remap can't be reused, so free it.
+      c->buffer.Destroy();
+      it = buffer->uploads.erase(it);
+      continue;
+    }
+    if (c->ptr) {
+      chunk = *it;
+      break;
+    }
+    ++it;
+  }
+  if (!chunk) {
+    chunk = buffer->staging->CreateUploadChunk(buffer->sizeInBytes);
+    buffer->uploads.push_back(chunk);
+  }
+  buffer->upload = chunk.get();
+  void* ptr = chunk->ptr;
+  gPendingUploads[ptr] = {std::move(chunk), buffer->buffer, buffer->staging};
+  return WrapMappedRange(buffer, ptr, &FinishUpload);
+}
+
 Buffer* Buffer_Buffer_Device_uint(int      qualifiers,
                                   Type*    type,
                                   Device*  device,
                                   uint32_t dynamicArraySize) {
   wgpu::BufferDescriptor desc;
   desc.usage = toDawnBufferUsage(qualifiers);
-  desc.size = type->GetSizeInBytes(dynamicArraySize);
+  uint32_t dynamicStride = 0;
+  if (qualifiers & Type::Qualifier::Dynamic) {
+    // "size" is the number of elements to sub-allocate.
+    dynamicStride = GetDynamicStride(type);
+    desc.size = static_cast<uint64_t>(dynamicStride) * std::max(dynamicArraySize, 1u);
+  } else {
+    desc.size = type->GetSizeInBytes(dynamicArraySize);
+  }
+  if (IsHostWriteableDeviceBuffer(qualifiers)) {
+    // The whole buffer is copied from its upload buffer, and copies are in units of 4 bytes.
+    desc.size = (desc.size + 3) & ~3ull;
+  }
   wgpu::Buffer b = device->device.CreateBuffer(&desc);
-  return new Buffer(device->device, b, dynamicArraySize, desc.size, type);
+  auto         result = new Buffer(GetStagingRing(device), b, dynamicArraySize, desc.size, type);
+  result->dynamicStride = dynamicStride;
+  return result;
 }
 
 Buffer* Buffer_Buffer_Device_T(int qualifiers, Type* type, Device* device, void* data) {
@@ -1260,7 +2219,24 @@ Buffer* Buffer_Buffer_Device_T(int qualifiers, Type* type, Device* device, void*
 
 Object* Buffer_MapRead(Buffer* buffer) { return MapSync(wgpu::MapMode::Read, buffer); }
 
-Object* Buffer_MapWrite(Buffer* buffer) { return MapSync(wgpu::MapMode::Write, buffer); }
+Object* Buffer_MapWrite(Buffer* buffer) {
+  if (!(buffer->buffer.GetUsage() & wgpu::BufferUsage::MapWrite)) { return MapForUpload(buffer); }
+  return MapSync(wgpu::MapMode::Write, buffer);
+}
+
+void Buffer_MapReadAsync(Buffer* buffer) {
+  if (buffer->buffer.GetMapState() == wgpu::BufferMapState::Unmapped) {
+    StartMap(wgpu::MapMode::Read, buffer);
+  }
+}
+
+bool Buffer_IsMapped(Buffer* buffer) {
+  // A map which completed with an error leaves the buffer unmapped.
+  if (buffer->mapFuture.id != 0) {
+    return WaitForMap(buffer, 0) && buffer->mapStatus == wgpu::MapAsyncStatus::Success;
+  }
+  return buffer->buffer.GetMapState() == wgpu::BufferMapState::Mapped;
+}
 
 void Buffer_Set(Buffer* buffer, void* data) {
   Type* type = buffer->type;
@@ -1271,11 +2247,57 @@ void Buffer_Set(Buffer* buffer, void* data) {
     length = array->length;
     data = array->ptr;
   }
-  wgpu::Queue queue = buffer->device.GetQueue();
-  queue.WriteBuffer(buffer->buffer, 0, data, type->GetSizeInBytes(length));
+  uint64_t size = type->GetSizeInBytes(length);
+  if (size > static_cast<uint64_t>(buffer->sizeInBytes)) {
+    ReportError(buffer->staging->GetDevice(), "Buffer.Set(): data is larger than the buffer");
+    return;
+  }
+  if (uint8_t* mapping = GetUploadMapping(buffer)) {
+    // The view's upload will overwrite the buffer when released, so write through it.
+    memcpy(mapping, data, size);
+    return;
+  }
+  buffer->staging->Write(buffer->buffer, 0, data, size);
+}
+
+void Buffer_SetRange(Buffer* buffer, uint32_t offset, void* data) {
+  Type*       type = buffer->type;
+  uint64_t    dstOffset;
+  const void* src;
+  uint64_t    size;
+  if (buffer->dynamicStride) {
+    // For dynamic buffers, "offset" selects the sub-allocated element.
+    dstOffset = static_cast<uint64_t>(offset) * buffer->dynamicStride;
+    src = data;
+    size = type->GetSizeInBytes();
+  } else if (type->IsUnsizedArray()) {
+    Array* array = static_cast<Array*>(data);
+    dstOffset = type->GetSizeInBytes(offset);
+    src = array->ptr;
+    size = type->GetSizeInBytes(array->length);
+  } else {
+    // "data" is not an array, so there is no range to read.
+    ReportError(buffer->staging->GetDevice(),
+                "Buffer.SetRange(): buffer is not an unsized array or dynamic");
+    return;
+  }
+  uint64_t capacity = static_cast<uint64_t>(buffer->sizeInBytes);
+  if (dstOffset > capacity || size > capacity - dstOffset) {
+    ReportError(buffer->staging->GetDevice(), "Buffer.SetRange(): range is outside the buffer");
+    return;
+  }
+  if (uint8_t* mapping = GetUploadMapping(buffer)) {
+    memcpy(mapping + dstOffset, src, size);
+    return;
+  }
+  buffer->staging->Write(buffer->buffer, dstOffset, src, size);
 }
 
-void Buffer_Destroy(Buffer* This) { delete This; }
+void Buffer_Destroy(Buffer* This) {
+  // The map callback refers to This.
+  WaitForMap(This, UINT64_MAX);
+  delete This;
+}
 
 CommandEncoder* CommandEncoder_CommandEncoder(Device* device) {
   wgpu::CommandEncoderDescriptor desc;
@@ -1285,6 +2307,7 @@ CommandEncoder* CommandEncoder_CommandEncoder(Device* device) {
 void CommandEncoder_Destroy(CommandEncoder* This) { delete This; }
 
 void Queue_Submit(Queue* queue, CommandBuffer* commandBuffer) {
+  queue->staging->Flush();
   queue->queue.Submit(1, &commandBuffer->commandBuffer);
 }
 
@@ -1300,10 +2323,39 @@ void ColorOutput_Destroy(ColorOutput* This) { delete This; }
 
 void DepthStencilOutput_Destroy(DepthStencilOutput* This) { delete This; }
 
-RenderPass* RenderPass_RenderPass_CommandEncoder_T(int             qualifiers,
-                                                   Type*           type,
-                                                   CommandEncoder* encoder,
-                                                   void*           data) {
+QuerySet* QuerySet_QuerySet(Device* device, uint32_t count) {
+  return new QuerySet(device->device, count);
+}
+
+void QuerySet_Destroy(QuerySet* This) { delete This; }
+
+uint32_t QuerySet_GetCount(QuerySet* This) { return This->count; }
+
+PassTimestampWrites* QuerySet_CreateTimestampWrites(QuerySet* This,
+                                                    uint32_t  beginIndex,
+                                                    uint32_t  endIndex) {
+  return new PassTimestampWrites(This->querySet, beginIndex, endIndex);
+}
+
+void QuerySet_Resolve(QuerySet* This, CommandEncoder* encoder) {
+  This->Resolve(encoder->encoder, This->count);
+}
+
+void QuerySet_ReadAsync(QuerySet* This) { This->ReadAsync(); }
+
+bool QuerySet_IsReady(QuerySet* This) { return This->Wait(0); }
+
+double QuerySet_GetElapsed(QuerySet* This, uint32_t beginIndex, uint32_t endIndex) {
+  This->Wait(UINT64_MAX);
+  return This->GetElapsed(beginIndex, endIndex);
+}
+
+void PassTimestampWrites_Destroy(PassTimestampWrites* This) { delete This; }
+
+static RenderPass* BeginRenderPass(Type*                      type,
+                                   CommandEncoder*            encoder,
+                                   void*                      data,
+                                   const PassTimestampWrites* timestampWrites) {
   PipelineData pipelineData;
   ExtractPipelineData(type, data, &pipelineData);
 
@@ -1313,11 +2365,32 @@ RenderPass* RenderPass_RenderPass_CommandEncoder_T(int             qualifiers,
   if (pipelineData.depthStencilAttachment.view != nullptr) {
     desc.depthStencilAttachment = &pipelineData.depthStencilAttachment;
   }
+  wgpu::RenderPassTimestampWrites dawnTimestampWrites;
+  if (timestampWrites && timestampWrites->querySet) {
+    dawnTimestampWrites = timestampWrites->ToDawn<wgpu::RenderPassTimestampWrites>();
+    desc.timestampWrites = &dawnTimestampWrites;
+  }
   auto result = encoder->encoder.BeginRenderPass(&desc);
   pipelineData.Set(result);
   return new RenderPass(result, type);
 }
 
+RenderPass* RenderPass_RenderPass_CommandEncoder_T(int             qualifiers,
+                                                   Type*           type,
+                                                   CommandEncoder* encoder,
+                                                   void*           data) {
+  return BeginRenderPass(type, encoder, data, nullptr);
+}
+
+RenderPass* RenderPass_RenderPass_CommandEncoder_T_PassTimestampWrites(
+    int                  qualifiers,
+    Type*                type,
+    CommandEncoder*      encoder,
+    void*                data,
+    PassTimestampWrites* timestampWrites) {
+  return BeginRenderPass(type, encoder, data, timestampWrites);
+}
+
 RenderPass* RenderPass_RenderPass_RenderPass(int qualifiers, Type* type, RenderPass* parent) {
   return new RenderPass(parent->encoder, type);
 }
@@ -1328,8 +2401,18 @@ void RenderPass_Set(RenderPass* This, void* data) {
   pipelineData.Set(This->encoder);
 }
 
+void RenderPass_SetDynamic(RenderPass* This, void* data, Array* elementIndices) {
+  PipelineData pipelineData;
+  ExtractPipelineData(This->type, data, &pipelineData);
+  pipelineData.elementIndices = static_cast<const uint32_t*>(elementIndices->ptr);
+  pipelineData.numElementIndices = elementIndices->length;
+  pipelineData.Set(This->encoder);
+}
+
 void RenderPass_SetPipeline(RenderPass* This, RenderPipeline* pipeline) {
-  This->encoder.SetPipeline(pipeline->pipeline);
+  WaitForPipeline(pipeline, UINT64_MAX);
+  // A failed async compile leaves no pipeline; its error has already been reported.
+  if (pipeline->pipeline) { This->encoder.SetPipeline(pipeline->pipeline); }
 }
 
 void RenderPass_Draw(RenderPass* This,
@@ -1349,29 +2432,147 @@ void RenderPass_DrawIndexed(RenderPass* This,
   This->encoder.DrawIndexed(indexCount, instanceCount, firstVertex, baseVertex, firstInstance);
 }
 
+void RenderPass_DrawIndirect(RenderPass* This, Buffer* indirectBuffer, uint32_t offset) {
+  This->encoder.DrawIndirect(indirectBuffer->buffer, offset * sizeof(uint32_t));
+}
+
+void RenderPass_DrawIndexedIndirect(RenderPass* This, Buffer* indirectBuffer, uint32_t offset) {
+  This->encoder.DrawIndexedIndirect(indirectBuffer->buffer, offset * sizeof(uint32_t));
+}
+
+void RenderPass_ExecuteBundle(RenderPass* This, RenderBundle* bundle) {
+  if (!bundle->bundle) { RenderBundle_Finish(bundle); }
+  This->encoder.ExecuteBundles(1, &bundle->bundle);
+}
+
 void RenderPass_End(RenderPass* This) { This->encoder.End(); }
 
 void RenderPass_Destroy(RenderPass* This) { delete This; }
 
-ComputePass* ComputePass_ComputePass_CommandEncoder_T(int             qualifiers,
-                                                      Type*           type,
-                                                      CommandEncoder* encoder,
-                                                      void*           data) {
+RenderBundle* RenderBundle_RenderBundle(int qualifiers, Type* type, Device* device, void* data) {
+  assert(type->IsClass());
+  // The attachment formats come from the same fields that describe the pipeline's targets.
+  PipelineLayout   pipelineLayout;
+  wgpu::BlendState blendState;
+  ExtractPipelineLayout(static_cast<ClassType*>(type), device, &blendState, &pipelineLayout);
+  std::vector<wgpu::TextureFormat> colorFormats;
+  for (const auto& colorTarget : pipelineLayout.colorTargets) {
+    colorFormats.push_back(colorTarget.format);
+  }
+  wgpu::RenderBundleEncoderDescriptor desc;
+  desc.colorFormatCount = colorFormats.size();
+  desc.colorFormats = colorFormats.data();
+  desc.depthStencilFormat = pipelineLayout.depthStencilTarget.format;
+  auto encoder = device->device.CreateRenderBundleEncoder(&desc);
+
   PipelineData pipelineData;
   ExtractPipelineData(type, data, &pipelineData);
-  wgpu::ComputePassDescriptor desc;
-  auto                        passEncoder = encoder->encoder.BeginComputePass(&desc);
+  pipelineData.Set(encoder);
+  return new RenderBundle(device->device, encoder, type);
+}
+
+// Returns true if the bundle is still recording.  Once Finish() has run there is no encoder, so
+// further commands are reported and dropped.
+static bool IsRecording(RenderBundle* bundle) {
+  if (bundle->encoder) { return true; }
+  ReportError(bundle->device, "render bundle already finished");
+  return false;
+}
+
+void RenderBundle_Set(RenderBundle* This, void* data) {
+  if (!IsRecording(This)) { return; }
+  PipelineData pipelineData;
+  ExtractPipelineData(This->type, data, &pipelineData);
+  pipelineData.Set(This->encoder);
+}
+
+void RenderBundle_SetPipeline(RenderBundle* This, RenderPipeline* pipeline) {
+  if (!IsRecording(This)) { return; }
+  WaitForPipeline(pipeline, UINT64_MAX);
+  // A failed async compile leaves no pipeline; its error has already been reported.
+  if (pipeline->pipeline) { This->encoder.SetPipeline(pipeline->pipeline); }
+}
+
+void RenderBundle_Draw(RenderBundle* This,
+                       uint32_t      vertexCount,
+                       uint32_t      instanceCount,
+                       uint32_t      firstVertex,
+                       uint32_t      firstInstance) {
+  if (!IsRecording(This)) { return; }
+  This->encoder.Draw(vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
+void RenderBundle_DrawIndexed(RenderBundle* This,
+                              uint32_t      indexCount,
+                              uint32_t      instanceCount,
+                              uint32_t      firstVertex,
+                              uint32_t      baseVertex,
+                              uint32_t      firstInstance) {
+  if (!IsRecording(This)) { return; }
+  This->encoder.DrawIndexed(indexCount, instanceCount, firstVertex, baseVertex, firstInstance);
+}
+
+void RenderBundle_DrawIndirect(RenderBundle* This, Buffer* indirectBuffer, uint32_t offset) {
+  if (!IsRecording(This)) { return; }
+  This->encoder.DrawIndirect(indirectBuffer->buffer, offset * sizeof(uint32_t));
+}
+
+void RenderBundle_DrawIndexedIndirect(RenderBundle* This, Buffer* indirectBuffer, uint32_t offset) {
+  if (!IsRecording(This)) { return; }
+  This->encoder.DrawIndexedIndirect(indirectBuffer->buffer, offset * sizeof(uint32_t));
+}
+
+void RenderBundle_Finish(RenderBundle* This) {
+  if (This->bundle) { return; }
+  wgpu::RenderBundleDescriptor desc;
+  This->bundle = This->encoder.Finish(&desc);
+  This->encoder = nullptr;
+}
+
+void RenderBundle_Destroy(RenderBundle* This) { delete This; }
+
+static ComputePass* BeginComputePass(Type*                      type,
+                                     CommandEncoder*            encoder,
+                                     void*                      data,
+                                     const PassTimestampWrites* timestampWrites) {
+  PipelineData pipelineData;
+  ExtractPipelineData(type, data, &pipelineData);
+  wgpu::ComputePassDescriptor      desc;
+  wgpu::ComputePassTimestampWrites dawnTimestampWrites;
+  if (timestampWrites && timestampWrites->querySet) {
+    dawnTimestampWrites = timestampWrites->ToDawn<wgpu::ComputePassTimestampWrites>();
+    desc.timestampWrites = &dawnTimestampWrites;
+  }
+  auto passEncoder = encoder->encoder.BeginComputePass(&desc);
   pipelineData.Set(passEncoder);
   return new ComputePass(passEncoder, type);
 }
 
+ComputePass* ComputePass_ComputePass_CommandEncoder_T(int             qualifiers,
+                                                      Type*           type,
+                                                      CommandEncoder* encoder,
+                                                      void*           data) {
+  return BeginComputePass(type, encoder, data, nullptr);
+}
+
+ComputePass* ComputePass_ComputePass_CommandEncoder_T_PassTimestampWrites(
+    int                  qualifiers,
+    Type*                type,
+    CommandEncoder*      encoder,
+    void*                data,
+    PassTimestampWrites* timestampWrites) {
+  return BeginComputePass(type, encoder, data, timestampWrites);
+}
+
 ComputePass* ComputePass_ComputePass_ComputePass(int qualifiers, Type* type, ComputePass* parent) {
   assert(type->IsClass());
   return new ComputePass(parent->encoder, static_cast<ClassType*>(type));
 }
 
 void ComputePass_SetPipeline(ComputePass* This, ComputePipeline* pipeline) {
-  This->encoder.SetPipeline(pipeline->pipeline);
+  WaitForPipeline(pipeline, UINT64_MAX);
+  // A failed async compile leaves no pipeline; its error has already been reported.
+  if (pipeline->pipeline) { This->encoder.SetPipeline(pipeline->pipeline); }
 }
 
 void ComputePass_Set(ComputePass* This, void* data) {
@@ -1380,6 +2581,14 @@ void ComputePass_Set(ComputePass* This, void* data) {
   pipelineData.Set(This->encoder);
 }
 
+void ComputePass_SetDynamic(ComputePass* This, void* data, Array* elementIndices) {
+  PipelineData pipelineData;
+  ExtractPipelineData(This->type, data, &pipelineData);
+  pipelineData.elementIndices = static_cast<const uint32_t*>(elementIndices->ptr);
+  pipelineData.numElementIndices = elementIndices->length;
+  pipelineData.Set(This->encoder);
+}
+
 void ComputePass_Dispatch(ComputePass* This,
                           uint32_t     workgroupCountX,
                           uint32_t     workgroupCountY,
@@ -1387,10 +2596,46 @@ void ComputePass_Dispatch(ComputePass* This,
   This->encoder.DispatchWorkgroups(workgroupCountX, workgroupCountY, workgroupCountZ);
 }
 
+void ComputePass_DispatchIndirect(ComputePass* This, Buffer* indirectBuffer, uint32_t offset) {
+  This->encoder.DispatchWorkgroupsIndirect(indirectBuffer->buffer, offset * sizeof(uint32_t));
+}
+
 void ComputePass_End(ComputePass* This) { This->encoder.End(); }
 
 void ComputePass_Destroy(ComputePass* This) { delete This; }
 
+static std::string ToString(Array* str) {
+  return std::string(static_cast<const char*>(str->ptr), str->length);
+}
+
+Profiler* Profiler_Profiler(Device* device, uint32_t maxPasses) {
+  return new Profiler(device->device, maxPasses);
+}
+
+void Profiler_Destroy(Profiler* This) { delete This; }
+
+// False if the device lacks timestamp queries, in which case no passes are timed.
+bool Profiler_IsSupported(Profiler* This) { return This->frames[0].querySet->querySet != nullptr; }
+
+PassTimestampWrites* Profiler_Timestamps(Profiler* This, Array* name) {
+  return This->Timestamps(ToString(name));
+}
+
+void Profiler_Resolve(Profiler* This, CommandEncoder* encoder) { This->Resolve(encoder->encoder); }
+
+void Profiler_ReadAsync(Profiler* This) { This->ReadAsync(); }
+
+bool Profiler_Update(Profiler* This) { return This->Update(); }
+
+double Profiler_GetDuration(Profiler* This, Array* name) {
+  auto it = This->durations.find(ToString(name));
+  return it != This->durations.end() ? it->second : 0.0;
+}
+
+uint32_t Profiler_GetEventCount(Profiler* This) { return This->events.size(); }
+
+bool Profiler_WriteTrace(Profiler* This, Array* path) { return This->WriteTrace(ToString(path)); }
+
 CommandBuffer* CommandEncoder_Finish(CommandEncoder* encoder) {
   return new CommandBuffer(encoder->encoder.Finish());
 }
@@ -1429,6 +2674,12 @@ float Math_rand() { return (float)(rand() % 100) / 100.0f; }
 
 void Math_Destroy(Math* This) {}
 
+bool Subgroup_IsSupported(Device* device) {
+  return device->device.HasFeature(wgpu::FeatureName::Subgroups);
+}
+
+void Subgroup_Destroy(Subgroup* This) {}
+
 #if !(defined(__APPLE__) && TARGET_OS_IPHONE)
 void System_Print(Array* buffer) {
   fwrite(buffer->ptr, 1, buffer->length, stdout);
@@ -1440,6 +2691,8 @@ void System_PrintLine(Array* buffer) {
 }
 #endif
 
+void System_ProcessEvents() { gInstance.ProcessEvents(); }
+
 void System_Abort() {
   printf("  Y__Y\n");
   printf("--\\__(x)==     (pining for the fjords)\n");
@@ -1454,7 +2707,25 @@ void System_Destroy(System* This) {}
 
 void Event_Destroy(Event* This) { delete This; }
 
-wgpu::Device CreateDawnDevice(wgpu::BackendType type, const wgpu::DeviceDescriptor* desc) {
+#ifndef __EMSCRIPTEN__
+static BlobCache* GetBlobCache(const char* defaultDir) {
+  if (gBlobCache) return gBlobCache.get();
+  const char* dir = getenv("TOUCAN_PIPELINE_CACHE_DIR");
+  if (!dir) dir = defaultDir;
+  if (!dir || !*dir) return nullptr;
+  uint64_t maxMB = kDefaultPipelineCacheMaxMB;
+  if (const char* env = getenv("TOUCAN_PIPELINE_CACHE_MAX_MB")) {
+    maxMB = strtoull(env, nullptr, 10);
+  }
+  if (maxMB == 0) return nullptr;
+  gBlobCache = std::make_unique<BlobCache>(dir, maxMB << 20);
+  return gBlobCache.get();
+}
+#endif
+
+wgpu::Device CreateDawnDevice(wgpu::BackendType      type,
+                              wgpu::DeviceDescriptor* desc,
+                              const char*             cacheDir) {
   if (!gInstance) {
 #ifndef __EMSCRIPTEN__
     DawnProcTable backendProcs = dawn::native::GetProcs();
@@ -1476,13 +2747,50 @@ wgpu::Device CreateDawnDevice(wgpu::BackendType type, const wgpu::DeviceDescript
   if (gInstance.WaitAny(1, &aWaitInfo, UINT64_MAX) != wgpu::WaitStatus::Success) { return nullptr; }
   if (!adapter) return nullptr;
 
+#ifndef __EMSCRIPTEN__
+  // The browser manages its own shader cache, so the blob cache is native-only.
+  wgpu::DawnCacheDeviceDescriptor cacheDesc;
+  if (BlobCache* cache = GetBlobCache(cacheDir)) {
+    cacheDesc.loadDataFunction = [](const void* key, size_t keySize, void* value, size_t valueSize,
+                                    void* userdata) {
+      return static_cast<BlobCache*>(userdata)->Load(key, keySize, value, valueSize);
+    };
+    cacheDesc.storeDataFunction = [](const void* key, size_t keySize, const void* value,
+                                     size_t valueSize, void* userdata) {
+      static_cast<BlobCache*>(userdata)->Store(key, keySize, value, valueSize);
+    };
+    cacheDesc.functionUserdata = cache;
+    cacheDesc.nextInChain = desc->nextInChain;
+    desc->nextInChain = &cacheDesc;
+  }
+#endif
+
+  // Timestamp queries back QuerySet and Profiler; without them, passes are simply not timed.
+  // Subgroups back the Subgroup class; programs check Subgroup.IsSupported() and fall back.
+  const wgpu::FeatureName*       requiredFeatures = desc->requiredFeatures;
+  size_t                         requiredFeatureCount = desc->requiredFeatureCount;
+  std::vector<wgpu::FeatureName> features(requiredFeatures, requiredFeatures + requiredFeatureCount);
+  for (auto feature : {wgpu::FeatureName::TimestampQuery, wgpu::FeatureName::Subgroups}) {
+    if (adapter.HasFeature(feature)) { features.push_back(feature); }
+  }
+  if (features.size() > requiredFeatureCount) {
+    desc->requiredFeatures = features.data();
+    desc->requiredFeatureCount = features.size();
+  }
+
   wgpu::Device device;
   auto deviceFuture = adapter.RequestDevice(desc, wgpu::CallbackMode::WaitAnyOnly,
       [&device](wgpu::RequestDeviceStatus status, wgpu::Device d, const char* msg) {
     device = d;
   });
   wgpu::FutureWaitInfo dWaitInfo = { deviceFuture };
-  if (gInstance.WaitAny(1, &dWaitInfo, UINT64_MAX) != wgpu::WaitStatus::Success) { return nullptr; }
+  auto                 waitStatus = gInstance.WaitAny(1, &dWaitInfo, UINT64_MAX);
+#ifndef __EMSCRIPTEN__
+  if (desc->nextInChain == &cacheDesc) { desc->nextInChain = cacheDesc.nextInChain; }
+#endif
+  desc->requiredFeatures = requiredFeatures;
+  desc->requiredFeatureCount = requiredFeatureCount;
+  if (waitStatus != wgpu::WaitStatus::Success) { return nullptr; }
   return device;
 }
 
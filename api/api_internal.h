@@ -15,13 +15,43 @@
 #ifndef _APIINTERNAL_H
 #define _APIINTERNAL_H
 
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <webgpu/webgpu_cpp.h>
 
 namespace Toucan {
 
+class ClassType;
+struct BindGroupCache;
+struct Method;
+struct StagingRing;
+
 struct Device {
   Device(wgpu::Device d) : device(d) {}
   wgpu::Device device;
+
+  // Dawn objects derived from program types, which never change at runtime.
+  std::unordered_map<Method*, wgpu::ShaderModule>        shaderModules;
+  std::unordered_map<Type*, wgpu::BindGroupLayout>       bindGroupLayouts;
+  std::unordered_map<ClassType*, wgpu::PipelineLayout>   pipelineLayouts;
+  std::unordered_map<std::string, wgpu::RenderPipeline>  renderPipelines;
+  std::unordered_map<std::string, wgpu::ComputePipeline> computePipelines;
+  uint32_t                                               cacheHits = 0;
+  uint32_t                                               cacheMisses = 0;
+
+  // Async pipeline compiles in flight, whose callbacks fill in the pipeline caches above.
+  std::vector<wgpu::Future>                              pendingPipelines;
+
+  // Shared with this device's buffers and queues, which may outlive it.
+  std::shared_ptr<StagingRing>                           staging;
+
+  // Bind groups keyed on their contents; bound objects hold weak references to evict entries.
+  std::shared_ptr<BindGroupCache>                        bindGroupCache;
 };
 
 struct SwapChain {
@@ -34,9 +64,30 @@ struct SwapChain {
   void*               pool;
 };
 
+// File-backed storage for Dawn's blob cache, so that backend shader and pipeline compiles
+// survive across runs. Each entry is one file named by a hash of its key; once the directory
+// would grow past maxSize bytes, the least recently used entries are removed.
+struct BlobCache {
+  BlobCache(const std::string& d, uint64_t m);
+  size_t Load(const void* key, size_t keySize, void* value, size_t valueSize);
+  void   Store(const void* key, size_t keySize, const void* value, size_t valueSize);
+  void   Evict(uint64_t targetSize);
+  std::filesystem::path PathFor(const void* key, size_t keySize) const;
+
+  std::filesystem::path dir;
+  uint64_t              maxSize;
+  uint64_t              totalSize = 0;
+  std::mutex            mutex;
+};
+
 wgpu::TextureFormat GetPreferredPixelFormat();
 wgpu::TextureFormat ToDawnTextureFormat(Type* type);
-wgpu::Device CreateDawnDevice(wgpu::BackendType type, const wgpu::DeviceDescriptor* desc);
+
+// Creates a device on the given backend.  If cacheDir is non-null (or TOUCAN_PIPELINE_CACHE_DIR
+// is set), compiled shaders and pipelines are cached there, up to TOUCAN_PIPELINE_CACHE_MAX_MB.
+wgpu::Device CreateDawnDevice(wgpu::BackendType      type,
+                              wgpu::DeviceDescriptor* desc,
+                              const char*             cacheDir = nullptr);
 
 }  // namespace Toucan
 #endif  // _APIINTERNAL_H
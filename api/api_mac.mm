@@ -182,7 +182,10 @@ Device* Device_Device() {
     }
   );
 
-  wgpu::Device device = CreateDawnDevice(wgpu::BackendType::Metal, &desc);
+  NSString* caches =
+      NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+  NSString* cacheDir = [caches stringByAppendingPathComponent:@"Toucan"];
+  wgpu::Device device = CreateDawnDevice(wgpu::BackendType::Metal, &desc, cacheDir.UTF8String);
   if (!device) { return nullptr; }
   return new Device(device);
 }
@@ -18,6 +18,7 @@
 #include <windows.h>
 
 #include <memory>
+#include <string>
 
 #include <webgpu/webgpu_cpp.h>
 
@@ -134,7 +135,12 @@ Device* Device_Device() {
     }
   );
 
-  wgpu::Device device = CreateDawnDevice(wgpu::BackendType::D3D12, &desc);
+  std::string cacheDir;
+  if (const char* localAppData = getenv("LOCALAPPDATA")) {
+    cacheDir = std::string(localAppData) + "\\Toucan\\PipelineCache";
+  }
+  wgpu::Device device = CreateDawnDevice(wgpu::BackendType::D3D12, &desc,
+                                         cacheDir.empty() ? nullptr : cacheDir.c_str());
   if (!device) { return nullptr; }
   return new Device(device);
 }
@@ -19,8 +19,10 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <string>
 
 #define Window XWindow
 #include <X11/Xlib.h>
@@ -113,7 +115,14 @@ Device* Device_Device() {
     }
   );
 
-  wgpu::Device device = CreateDawnDevice(wgpu::BackendType::Vulkan, &desc);
+  std::string cacheDir;
+  if (const char* xdgCache = getenv("XDG_CACHE_HOME")) {
+    cacheDir = std::string(xdgCache) + "/toucan";
+  } else if (const char* home = getenv("HOME")) {
+    cacheDir = std::string(home) + "/.cache/toucan";
+  }
+  wgpu::Device device = CreateDawnDevice(wgpu::BackendType::Vulkan, &desc,
+                                         cacheDir.empty() ? nullptr : cacheDir.c_str());
   if (!device) { return nullptr; }
   return new Device(device);
 }
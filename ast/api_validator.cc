@@ -60,6 +60,32 @@ bool IsValidComputePipelineField(Type* type) {
   return classType->GetTemplate() == NativeClass::BindGroup;
 }
 
+bool IsStorageTextureTemplate(NativeClass templ) {
+  return templ == NativeClass::Texture1D || templ == NativeClass::Texture2D ||
+         templ == NativeClass::Texture2DArray || templ == NativeClass::Texture3D;
+}
+
+// Returns the pixel format of a bind group field that is a read-write storage texture (neither
+// readonly nor writeonly), or nullptr for anything else.
+Type* GetReadWriteStorageTextureFormat(Type* type) {
+  if (!type->IsStrongPtr()) return nullptr;
+  type = static_cast<StrongPtrType*>(type)->GetBaseType();
+  int qualifiers;
+  type = type->GetUnqualifiedType(&qualifiers);
+  if (!type->IsClass()) return nullptr;
+  auto classType = static_cast<ClassType*>(type);
+  if (!IsStorageTextureTemplate(classType->GetTemplate())) return nullptr;
+  if (qualifiers & (Type::Qualifier::ReadOnly | Type::Qualifier::WriteOnly)) return nullptr;
+  return classType->GetTemplateArgs()[0];
+}
+
+// Core WebGPU only supports read-write storage access for the single-channel 32-bit formats.
+bool IsValidReadWriteStorageFormat(Type* format) {
+  if (!format->IsClass()) return false;
+  auto name = static_cast<ClassType*>(format)->GetName();
+  return name == "R32float" || name == "R32uint" || name == "R32sint";
+}
+
 bool IsValidBindGroupFieldType(Type* type) {
   if (!type->IsStrongPtr()) return false;
   type = static_cast<StrongPtrType*>(type)->GetBaseType();
@@ -79,6 +105,7 @@ bool IsValidBindGroupFieldType(Type* type) {
       templ == NativeClass::SampleableTexture2DArray || templ == NativeClass::SampleableTexture3D ||
       templ == NativeClass::SampleableTextureCube)
     return true;
+  if (IsStorageTextureTemplate(templ) && (qualifiers & Type::Qualifier::Storage)) return true;
   return false;
 }
 
@@ -100,11 +127,14 @@ void APIValidator::ValidateType(Type* type, const FileLocation& fileLocation) {
 
   if (classTemplate == NativeClass::Buffer) {
     ValidateBuffer(classType, qualifiers);
+  } else if (classTemplate == NativeClass::Atomic) {
+    ValidateAtomic(classType);
   } else if (classTemplate == NativeClass::BindGroup) {
     ValidateBindGroup(classType);
   } else if (classTemplate == NativeClass::RenderPipeline) {
     ValidateRenderPipeline(classType);
-  } else if (classTemplate == NativeClass::RenderPass) {
+  } else if (classTemplate == NativeClass::RenderPass ||
+             classTemplate == NativeClass::RenderBundle) {
     ValidateRenderPipelineFields(classType);
   } else if (classTemplate == NativeClass::ComputePipeline) {
     ValidateComputePipeline(classType);
@@ -146,9 +176,25 @@ void APIValidator::ValidateIndexBufferType(ClassType* buffer, Type* type) {
   }
 }
 
+void APIValidator::ValidateIndirectBufferType(ClassType* buffer, Type* type) {
+  if (!type->IsUnsizedArray()) {
+    Error(buffer, "%s is not a runtime-sized array", type->ToString().c_str());
+    return;
+  }
+  type = static_cast<ArrayType*>(type)->GetElementType();
+  if (!type->IsUInt()) {
+    Error(buffer, "%s is not a valid indirect buffer type; must be uint",
+          type->ToString().c_str());
+  }
+}
+
 void APIValidator::ValidateUniformDataType(ClassType* buffer, Type* type) {
   if (type->IsClass()) {
     auto classType = static_cast<ClassType*>(type);
+    if (classType->GetTemplate() == NativeClass::Atomic) {
+      Error(buffer, "%s: atomics are prohibited in uniform buffers", type->ToString().c_str());
+      return;
+    }
     for (const auto& field : classType->GetFields()) {
       ValidateUniformDataType(buffer, field->type);
     }
@@ -166,6 +212,10 @@ void APIValidator::ValidateUniformDataType(ClassType* buffer, Type* type) {
 void APIValidator::ValidateStorageDataType(ClassType* buffer, Type* type) {
   if (type->IsClass()) {
     auto classType = static_cast<ClassType*>(type);
+    if (classType->GetTemplate() == NativeClass::Atomic) {
+      ValidateAtomic(classType);
+      return;
+    }
     for (const auto& field : classType->GetFields()) {
       ValidateStorageDataType(buffer, field->type);
     }
@@ -176,6 +226,13 @@ void APIValidator::ValidateStorageDataType(ClassType* buffer, Type* type) {
   }
 }
 
+void APIValidator::ValidateAtomic(ClassType* atomic) {
+  Type* type = atomic->GetTemplateArgs()[0];
+  if (!type->IsInt() && !type->IsUInt()) {
+    Error(atomic, "%s is not a valid atomic type; must be int or uint", type->ToString().c_str());
+  }
+}
+
 void APIValidator::ValidateBuffer(ClassType* buffer, int qualifiers) {
   struct QualifierInfo {
     Type::Qualifier qualifier;
@@ -185,18 +242,28 @@ void APIValidator::ValidateBuffer(ClassType* buffer, int qualifiers) {
       Type::Qualifier::Sampleable,   "sampleable",  Type::Qualifier::Renderable, "renderable",
       Type::Qualifier::Unfilterable, "unfilterable"};
   int DeviceBufferQualifiers = Type::Qualifier::Vertex | Type::Qualifier::Index |
-                               Type::Qualifier::Uniform | Type::Qualifier::Storage;
+                               Type::Qualifier::Uniform | Type::Qualifier::Storage |
+                               Type::Qualifier::Indirect;
 
   auto type = buffer->GetTemplateArgs()[0];
   if (qualifiers & Type::Qualifier::Vertex) { ValidateVertexBufferType(buffer, type); }
   if (qualifiers & Type::Qualifier::Index) { ValidateIndexBufferType(buffer, type); }
   if (qualifiers & Type::Qualifier::Uniform) { ValidateUniformDataType(buffer, type); }
   if (qualifiers & Type::Qualifier::Storage) { ValidateStorageDataType(buffer, type); }
+  if (qualifiers & Type::Qualifier::Indirect) { ValidateIndirectBufferType(buffer, type); }
+  // A hostwriteable device buffer is filled in place through MapWrite(), but device buffers
+  // can't be read back directly.
   if (qualifiers & DeviceBufferQualifiers) {
-    if (qualifiers & (Type::Qualifier::HostReadable | Type::Qualifier::HostWriteable)) {
+    if (qualifiers & Type::Qualifier::HostReadable) {
       Error(buffer, "buffer can not have both host and device qualifiers");
     }
   }
+  if (qualifiers & Type::Qualifier::Dynamic) {
+    if (!(qualifiers & (Type::Qualifier::Uniform | Type::Qualifier::Storage))) {
+      Error(buffer, "dynamic buffer must be uniform or storage");
+    }
+    if (type->IsUnsizedArray()) { Error(buffer, "dynamic buffer can not be an unsized array"); }
+  }
   for (auto q : invalidBufferQualifiers) {
     if (qualifiers & q.qualifier) { Error(buffer, "invalid buffer qualifier: %s", q.str); }
   }
@@ -212,6 +279,12 @@ void APIValidator::ValidateBindGroup(ClassType* bindGroup) {
   for (const auto& field : classType->GetFields()) {
     if (!IsValidBindGroupFieldType(field->type)) {
       Error(bindGroup, "invalid bind group field type %s", field->type->ToString().c_str());
+    } else if (auto format = GetReadWriteStorageTextureFormat(field->type)) {
+      if (!IsValidReadWriteStorageFormat(format)) {
+        Error(bindGroup,
+              "read-write storage texture %s requires an R32 format; add readonly or writeonly",
+              field->type->ToString().c_str());
+      }
     }
   }
 }
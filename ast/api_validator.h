@@ -30,8 +30,10 @@ class APIValidator {
   void ValidateVertexAttributeType(ClassType* buffer, Type* type);
   void ValidateVertexBufferType(ClassType* buffer, Type* type);
   void ValidateIndexBufferType(ClassType* buffer, Type* type);
+  void ValidateIndirectBufferType(ClassType* buffer, Type* type);
   void ValidateUniformDataType(ClassType* buffer, Type* type);
   void ValidateStorageDataType(ClassType* buffer, Type* type);
+  void ValidateAtomic(ClassType* atomic);
   void ValidateBuffer(ClassType* classType, int qualifiers);
   void ValidateBindGroup(ClassType* classType);
   void ValidateRenderPipelineFields(ClassType* renderPipeline);
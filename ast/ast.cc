@@ -14,6 +14,9 @@
 
 #include "ast.h"
 
+#include <algorithm>
+#include <bit>
+
 namespace Toucan {
 
 ASTNode::ASTNode() {}
@@ -192,18 +195,66 @@ Type* UnresolvedListExpr::GetType(TypeTable* types) {
   return types->GetList(std::move(vars));
 }
 
-MethodDecl::MethodDecl(int modifiers, std::array<uint32_t, 3> workgroupSize, std::string id, Stmts* formalArguments, int thisQualifiers, ASTType* returnType, Expr* initializer, Stmts* body)
+PackedListExpr::PackedListExpr(Values                values,
+                               size_t                offset,
+                               std::vector<uint32_t> shape,
+                               bool                  isFloat,
+                               Type*                 type)
+    : values_(values), offset_(offset), shape_(std::move(shape)), isFloat_(isFloat), type_(type) {}
+
+Type* PackedListExpr::GetType(TypeTable* types) {
+  if (type_) { return type_; }
+  if (!listType_) {
+    // Every sublist has the same shape, so build the list type from the inside out.
+    listType_ = isFloat_ ? static_cast<Type*>(types->GetFloat()) : types->GetInt();
+    for (auto dim = shape_.rbegin(); dim != shape_.rend(); ++dim) {
+      VarVector vars;
+      for (uint32_t i = 0; i < *dim; ++i) {
+        vars.push_back(std::make_shared<Var>("", listType_));
+      }
+      listType_ = types->GetList(std::move(vars));
+    }
+  }
+  return listType_;
+}
+
+ArgList* PackedListExpr::Expand(NodeVector* nodes) {
+  std::vector<uint32_t> subShape(shape_.begin() + 1, shape_.end());
+  size_t                stride = 1;
+  for (auto dim : subShape) { stride *= dim; }
+  auto* argList = nodes->Make<ArgList>();
+  argList->SetFileLocation(GetFileLocation());
+  for (uint32_t i = 0; i < shape_[0]; ++i) {
+    size_t offset = offset_ + i * stride;
+    Expr*  expr;
+    if (!subShape.empty()) {
+      expr = nodes->Make<PackedListExpr>(values_, offset, subShape, isFloat_);
+    } else if (isFloat_) {
+      expr = nodes->Make<FloatConstant>(std::bit_cast<float>((*values_)[offset]));
+    } else {
+      expr = nodes->Make<IntConstant>((*values_)[offset], 32);
+    }
+    expr->SetFileLocation(GetFileLocation());
+    auto* arg = nodes->Make<Arg>("", expr);
+    arg->SetFileLocation(GetFileLocation());
+    argList->Append(arg);
+  }
+  return argList;
+}
+
+MethodDecl::MethodDecl(int modifiers, std::array<uint32_t, 3> workgroupSize, std::array<std::string, 3> workgroupSizeOverrides, std::string id, Stmts* formalArguments, int thisQualifiers, ASTType* returnType, Expr* initializer, Stmts* body)
     : modifiers_(modifiers),
       id_(id),
       workgroupSize_(workgroupSize),
+      workgroupSizeOverrides_(workgroupSizeOverrides),
       formalArguments_(formalArguments),
       thisQualifiers_(thisQualifiers),
       returnType_(returnType),
       initializer_(initializer),
       body_(body) {}
 
-ConstDecl::ConstDecl(std::string id, Expr* expr)
-    : id_(id), expr_(expr) {}
+ConstDecl::ConstDecl(std::string id, Expr* expr, bool isOverride)
+    : id_(id), expr_(expr), isOverride_(isOverride) {}
 
 VarDeclaration::VarDeclaration(std::string id, ASTType* type, Expr* initExpr)
     : id_(id), type_(type), initExpr_(initExpr) {}
@@ -296,6 +347,9 @@ UIntConstant::UIntConstant(uint32_t value, uint32_t bits) : value_(value), bits_
 
 Type* UIntConstant::GetType(TypeTable* types) { return types->GetInteger(bits_, false); }
 
+SpecConstant::SpecConstant(std::string id, uint32_t specId, Expr* defaultValue)
+    : id_(id), specId_(specId), defaultValue_(defaultValue) {}
+
 FloatConstant::FloatConstant(float value) : value_(value) {}
 
 Type* FloatConstant::GetType(TypeTable* types) { return types->GetFloat(); }
@@ -308,14 +362,19 @@ BoolConstant::BoolConstant(bool value) : value_(value) {}
 
 Type* BoolConstant::GetType(TypeTable* types) { return types->GetBool(); }
 
-Data::Data(std::unique_ptr<uint8_t[]> data, size_t size)
-    : data_(std::move(data)), size_(size) {}
+Data::Data(std::shared_ptr<uint8_t[]> data, size_t size, ArrayType* type)
+    : data_(std::move(data)), size_(size), type_(type) {}
 
 Type* Data::GetType(TypeTable* types) {
-  auto type = types->GetArrayType(types->GetUByte(), 0, MemoryLayout::Default);
-  return types->GetStrongPtrType(type);
+  return types->GetStrongPtrType(GetArrayType(types));
 }
 
+ArrayType* Data::GetArrayType(TypeTable* types) {
+  return type_ ? type_ : types->GetArrayType(types->GetUByte(), 0, MemoryLayout::Default);
+}
+
+UnresolvedData::UnresolvedData(ASTType* type, Data* data) : type_(type), data_(data) {}
+
 CastExpr::CastExpr(Type* type, Expr* expr) : type_(type), expr_(expr) {}
 
 bool CastExpr::IsTransparent(TypeTable* types) const {
@@ -350,13 +409,14 @@ void Stmts::Splice(Stmts* stmts) {
   stmts_.splice(stmts_.end(), std::move(stmts->stmts_));
 }
 
-void Stmts::AppendVar(std::shared_ptr<Var> var) { vars_.push_back(var); }
+void Stmts::AppendVar(std::shared_ptr<Var> var) {
+  varMap_.emplace(var->name, var.get());
+  vars_.push_back(var);
+}
 
 Var* Stmts::FindVar(const std::string& identifier) const {
-  for (auto var : vars_) {
-    if (var->name == identifier) return var.get();
-  }
-  return nullptr;
+  auto i = varMap_.find(identifier);
+  return i != varMap_.end() ? i->second : nullptr;
 }
 
 void Stmts::AppendConstant(std::string name, Expr* value) { constants_[name] = value; }
@@ -424,6 +484,27 @@ EnumDecl::EnumDecl(std::string name) : name_(name) {}
 
 NodeVector::NodeVector() {}
 
+NodeVector::~NodeVector() {
+  for (auto it = nodes_.rbegin(); it != nodes_.rend(); ++it) {
+    (*it)->~ASTNode();
+  }
+}
+
+void* NodeVector::Allocate(size_t size, size_t alignment) {
+  uint8_t* result = reinterpret_cast<uint8_t*>(
+      (reinterpret_cast<uintptr_t>(next_) + alignment - 1) & ~(alignment - 1));
+  if (!next_ || result + size > end_) {
+    size_t chunkSize = std::max(kChunkSize, size + alignment);
+    chunks_.push_back(std::make_unique<uint8_t[]>(chunkSize));
+    next_ = chunks_.back().get();
+    end_ = next_ + chunkSize;
+    result = reinterpret_cast<uint8_t*>(
+        (reinterpret_cast<uintptr_t>(next_) + alignment - 1) & ~(alignment - 1));
+  }
+  next_ = result + size;
+  return result;
+}
+
 ScopeStack::ScopeStack() {}
 
 Result ASTAutoType::Accept(Visitor* visitor) { return visitor->Visit(this); }
@@ -456,11 +537,13 @@ Result ClassTemplateDecl::Accept(Visitor* visitor) { return visitor->Visit(this)
 Result ClassTemplateInstance::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result ConstDecl::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result Data::Accept(Visitor* visitor) { return visitor->Visit(this); }
+Result UnresolvedData::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result EnumDecl::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result ExprList::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result ExprWithStmt::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result SmartToRawPtr::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result RawToSmartPtr::Accept(Visitor* visitor) { return visitor->Visit(this); }
+Result SpecConstant::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result ToRawArray::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result DoStatement::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result DoubleConstant::Accept(Visitor* visitor) { return visitor->Visit(this); }
@@ -489,6 +572,7 @@ Result UnresolvedCastExpr::Accept(Visitor* visitor) { return visitor->Visit(this
 Result UnresolvedDot::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result UnresolvedIdentifier::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result UnresolvedListExpr::Accept(Visitor* visitor) { return visitor->Visit(this); }
+Result PackedListExpr::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result UnresolvedInitializer::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result UnresolvedMethodCall::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result UnresolvedNewExpr::Accept(Visitor* visitor) { return visitor->Visit(this); }
@@ -17,8 +17,11 @@
 
 #include <assert.h>
 #include <list>
+#include <memory>
+#include <new>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -32,6 +35,7 @@ struct Var;
 class ClassDecl;
 class ClassTemplateDecl;
 class ClassTemplateInstance;
+class NodeVector;
 class Visitor;
 
 using Result = std::variant<void*, uint32_t>;
@@ -54,6 +58,7 @@ class ASTType : public ASTNode {
   virtual bool      IsClass() const { return false; }
   virtual bool      IsClassTemplateInstance() const { return false; }
   virtual bool      IsEnum() const { return false; }
+  virtual bool      IsFormalTemplateArg() const { return false; }
   virtual ASTType*  GetUnqualifiedType() { return this; }
 };
 
@@ -164,6 +169,7 @@ class ASTFormalTemplateArg : public ASTType {
  public:
   ASTFormalTemplateArg(std::string name);
   std::string  GetName() const { return name_; }
+  bool         IsFormalTemplateArg() const override { return true; }
   Result       Accept(Visitor* visitor) override;
  private:
   std::string  name_;
@@ -247,9 +253,12 @@ class Expr : public ASTNode {
   virtual bool  IsArrayAccess() const { return false; }
   virtual bool  IsFieldAccess() const { return false; }
   virtual bool  IsUnresolvedListExpr() const { return false; }
+  virtual bool  IsPackedListExpr() const { return false; }
   virtual bool  IsIntConstant() const { return false; }
+  virtual bool  IsUIntConstant() const { return false; }
   virtual bool  IsTempVarExpr() const { return false; }
   virtual bool  IsUnresolvedDot() const { return false; }
+  virtual bool  IsUnresolvedIdentifier() const { return false; }
   virtual bool  IsVarExpr() const { return false; }
 };
 
@@ -267,15 +276,32 @@ class HeapAllocation : public Expr {
 
 class Data : public Expr {
  public:
-  Data(std::unique_ptr<uint8_t[]> data, size_t size);
-  Result Accept(Visitor* visitor) override;
-  Type*  GetType(TypeTable* types) override;
-  void*  GetData() { return data_.get(); }
-  size_t GetSize() const { return size_; }
+  Data(std::shared_ptr<uint8_t[]> data, size_t size, ArrayType* type = nullptr);
+  Result     Accept(Visitor* visitor) override;
+  Type*      GetType(TypeTable* types) override;
+  ArrayType* GetArrayType(TypeTable* types);
+  void*      GetData() { return data_.get(); }
+  const std::shared_ptr<uint8_t[]>& GetBuffer() const { return data_; }
+  size_t     GetSize() const { return size_; }
 
  private:
-  std::unique_ptr<uint8_t[]> data_;
+  std::shared_ptr<uint8_t[]> data_;
   size_t                     size_;
+  ArrayType*                 type_;
+};
+
+// The contents of a file inline()d as an array of the given type.
+class UnresolvedData : public Expr {
+ public:
+  UnresolvedData(ASTType* type, Data* data);
+  Result   Accept(Visitor* visitor) override;
+  Type*    GetType(TypeTable* types) override { assert(false); return nullptr; }
+  ASTType* GetType() { return type_; }
+  Data*    GetData() { return data_; }
+
+ private:
+  ASTType* type_;
+  Data*    data_;
 };
 
 class IntConstant : public Expr {
@@ -299,6 +325,7 @@ class UIntConstant : public Expr {
   Result   Accept(Visitor* visitor) override;
   Type*    GetType(TypeTable* types) override;
   bool     IsConstant(TypeTable* types) const override { return true; }
+  bool     IsUIntConstant() const override { return true; }
   uint32_t GetValue() const { return value_; }
   uint32_t GetBits() const { return bits_; }
 
@@ -331,6 +358,23 @@ class DoubleConstant : public Expr {
   double value_;
 };
 
+// A pipeline-overridable constant, declared with "override" in a class.  Shaders see it as a
+// specialization constant with the given SpecId; host code sees its default value.
+class SpecConstant : public Expr {
+ public:
+  SpecConstant(std::string id, uint32_t specId, Expr* defaultValue);
+  Result      Accept(Visitor* visitor) override;
+  Type*       GetType(TypeTable* types) override { return defaultValue_->GetType(types); }
+  std::string GetID() const { return id_; }
+  uint32_t    GetSpecId() const { return specId_; }
+  Expr*       GetDefaultValue() const { return defaultValue_; }
+
+ private:
+  std::string id_;
+  uint32_t    specId_;
+  Expr*       defaultValue_;
+};
+
 class CastExpr : public Expr {
  public:
   CastExpr(Type* type, Expr* expr);
@@ -495,6 +539,35 @@ class UnresolvedListExpr : public Expr {
   ArgList* arglist_;
 };
 
+// A large, regularly-shaped list of int or float literals, packed by the lexer
+// into 32-bit values rather than parsed into one node per element. Until the
+// semantic pass gives it an array type, it behaves like the equivalent
+// UnresolvedListExpr; Expand() produces the first level of that list.
+class PackedListExpr : public Expr {
+ public:
+  using Values = std::shared_ptr<const std::vector<uint32_t>>;
+  PackedListExpr(Values values, size_t offset, std::vector<uint32_t> shape, bool isFloat,
+                 Type* type = nullptr);
+  Result   Accept(Visitor* visitor) override;
+  Type*    GetType(TypeTable* types) override;
+  bool     IsConstant(TypeTable* types) const override { return type_ != nullptr; }
+  bool     IsPackedListExpr() const override { return true; }
+  const Values&                GetValues() const { return values_; }
+  size_t                       GetOffset() const { return offset_; }
+  const std::vector<uint32_t>& GetShape() const { return shape_; }
+  bool                         IsFloat() const { return isFloat_; }
+  uint32_t                     GetValue(size_t i) const { return (*values_)[offset_ + i]; }
+  ArgList*                     Expand(NodeVector* nodes);
+
+ private:
+  Values                values_;
+  size_t                offset_;
+  std::vector<uint32_t> shape_;
+  bool                  isFloat_;
+  Type*                 type_;
+  Type*                 listType_ = nullptr;
+};
+
 class ArrayAccess : public Expr {
  public:
   ArrayAccess(Expr* expr, Expr* index);
@@ -541,6 +614,7 @@ class UnresolvedIdentifier : public Expr {
   UnresolvedIdentifier(std::string id);
   Result      Accept(Visitor* visitor) override;
   Type*       GetType(TypeTable* types) override { return nullptr; }
+  bool        IsUnresolvedIdentifier() const override { return true; }
   std::string GetID() { return id_; }
 
  private:
@@ -763,7 +837,10 @@ class Stmts : public Scope {
   Var*                    FindVar(const std::string& id) const;
   void                    AppendVar(std::shared_ptr<Var> v);
   const VarVector&        GetVars() const { return vars_; }
-  void                    ClearVars() { vars_.clear(); }
+  void                    ClearVars() {
+    vars_.clear();
+    varMap_.clear();
+  }
   bool                    ContainsReturn() const override;
   bool                    IsStmts() const override { return true; }
 
@@ -771,6 +848,7 @@ class Stmts : public Scope {
   std::list<Stmt*> stmts_;
   TypeMap          types_;
   VarVector        vars_;
+  std::unordered_map<std::string, Var*> varMap_;
   ExprMap          constants_;
 };
 
@@ -862,13 +940,17 @@ class ZeroInitStmt : public Stmt {
 
 class MethodDecl : public Stmt {
  public:
-              MethodDecl(int modifiers, std::array<uint32_t, 3> workgroupSize, std::string id,
+              MethodDecl(int modifiers, std::array<uint32_t, 3> workgroupSize,
+                         std::array<std::string, 3> workgroupSizeOverrides, std::string id,
                          Stmts* formalArguments, int thisQualifiers, ASTType* returnType,
                          Expr* initializer, Stmts* body);
   Result      Accept(Visitor* visitor) override;
   int         GetModifiers() const { return modifiers_; }
   std::string GetID() const { return id_; }
   std::array<uint32_t, 3> GetWorkgroupSize() const { return workgroupSize_; }
+  const std::array<std::string, 3>& GetWorkgroupSizeOverrides() const {
+    return workgroupSizeOverrides_;
+  }
   Stmts*      GetFormalArguments() const { return formalArguments_; }
   int         GetThisQualifiers() const { return thisQualifiers_; }
   ASTType*    GetReturnType() const { return returnType_; }
@@ -879,6 +961,7 @@ class MethodDecl : public Stmt {
   int                     modifiers_;
   std::string             id_;
   std::array<uint32_t, 3> workgroupSize_;
+  std::array<std::string, 3> workgroupSizeOverrides_;  // empty where the size is a literal
   Stmts*                  formalArguments_;
   int                     thisQualifiers_;
   ASTType*                returnType_;
@@ -888,14 +971,16 @@ class MethodDecl : public Stmt {
 
 class ConstDecl : public Stmt {
  public:
-              ConstDecl(std::string id, Expr* expr);
+              ConstDecl(std::string id, Expr* expr, bool isOverride = false);
   Result      Accept(Visitor* visitor) override;
   std::string GetID() { return id_; }
   Expr*       GetExpr() { return expr_; }
+  bool        IsOverride() const { return isOverride_; }
 
  private:
   std::string id_;
   Expr*       expr_;
+  bool        isOverride_;
 };
 
 class VarDeclaration : public Stmt {
@@ -1108,18 +1193,30 @@ class UnaryOp : public Expr {
   Op    op_;
 };
 
+// Owns all AST nodes produced by the parser and the copying passes. Nodes are
+// bump-allocated from large chunks, and destroyed all at once when the
+// NodeVector goes away.
 class NodeVector {
  public:
   NodeVector();
+  NodeVector(const NodeVector&) = delete;
+  NodeVector& operator=(const NodeVector&) = delete;
+  ~NodeVector();
   template <typename T, typename... ARGS>
   T* Make(ARGS&&... args) {
-    T* node = new T(std::forward<ARGS>(args)...);
-    nodes_.push_back(std::unique_ptr<ASTNode>(node));
+    T* node = new (Allocate(sizeof(T), alignof(T))) T(std::forward<ARGS>(args)...);
+    nodes_.push_back(node);
     return node;
   }
 
  private:
-  std::vector<std::unique_ptr<ASTNode>> nodes_;
+  void* Allocate(size_t size, size_t alignment);
+
+  static constexpr size_t                 kChunkSize = 64 * 1024;
+  std::vector<std::unique_ptr<uint8_t[]>> chunks_;
+  uint8_t*                                next_ = nullptr;
+  uint8_t*                                end_ = nullptr;
+  std::vector<ASTNode*>                   nodes_;
 };
 
 class ScopeStack : public std::deque<Scope*> {
@@ -1165,6 +1262,7 @@ class Visitor {
   virtual Result Visit(EnumDecl* node) { return Default(node); }
   virtual Result Visit(SmartToRawPtr* node) { return Default(node); }
   virtual Result Visit(RawToSmartPtr* node) { return Default(node); }
+  virtual Result Visit(SpecConstant* node) { return Default(node); }
   virtual Result Visit(Decls* node) { return Default(node); }
   virtual Result Visit(DoStatement* node) { return Default(node); }
   virtual Result Visit(DoubleConstant* node) { return Default(node); }
@@ -1192,11 +1290,13 @@ class Visitor {
   virtual Result Visit(UnaryOp* node) { return Default(node); }
   virtual Result Visit(DestroyStmt* node) { return Default(node); }
   virtual Result Visit(UnresolvedCastExpr* node) { return Default(node); }
+  virtual Result Visit(UnresolvedData* node) { return Default(node); }
   virtual Result Visit(UnresolvedInitializer* node) { return Default(node); }
   virtual Result Visit(UnresolvedDot* node) { return Default(node); }
   virtual Result Visit(UnresolvedStaticDot* node) { return Default(node); }
   virtual Result Visit(UnresolvedIdentifier* node) { return Default(node); }
   virtual Result Visit(UnresolvedListExpr* node) { return Default(node); }
+  virtual Result Visit(PackedListExpr* node) { return Default(node); }
   virtual Result Visit(UnresolvedNewExpr* node) { return Default(node); }
   virtual Result Visit(UnresolvedMethodCall* node) { return Default(node); }
   virtual Result Visit(UnresolvedStaticMethodCall* node) { return Default(node); }
@@ -74,6 +74,27 @@ Result ConstantFolder::Visit(UIntConstant* node) {
   return {};
 }
 
+void ConstantFolder::StorePackedList(Type* type, PackedListExpr* node, size_t* index, char* data) {
+  type = type->GetUnqualifiedType();
+  if (type->IsArrayLike()) {
+    auto arrayLikeType = static_cast<ArrayLikeType*>(type);
+    Type* elementType = arrayLikeType->GetElementType();
+    for (uint32_t i = 0; i < arrayLikeType->GetNumElements(); ++i) {
+      StorePackedList(elementType, node, index, data);
+      data += elementType->GetSizeInBytes();
+    }
+  } else {
+    // Values are already converted to the element type by the semantic pass.
+    *reinterpret_cast<uint32_t*>(data) = node->GetValue((*index)++);
+  }
+}
+
+Result ConstantFolder::Visit(PackedListExpr* node) {
+  size_t index = 0;
+  StorePackedList(node->GetType(types_), node, &index, static_cast<char*>(data_));
+  return {};
+}
+
 Result ConstantFolder::Visit(FloatConstant* node) {
   Store<float>(node->GetValue());
   return {};
@@ -28,6 +28,7 @@ class ConstantFolder : public Visitor {
   template<class T> void IntegralBinOp(BinOpNode::Op, void* lhs, void* rhs);
   template<class T> void FloatingPointBinOp(BinOpNode::Op, void* lhs, void* rhs);
   template<class T> void StoreUnaryOp(UnaryOp::Op, void* rhs);
+  void   StorePackedList(Type* type, PackedListExpr* node, size_t* index, char* data);
   Result Visit(CastExpr* node) override;
   Result Visit(BinOpNode* node) override;
   Result Visit(BoolConstant* node) override;
@@ -36,6 +37,7 @@ class ConstantFolder : public Visitor {
   Result Visit(FloatConstant* node) override;
   Result Visit(Initializer* node) override;
   Result Visit(IntConstant* node) override;
+  Result Visit(PackedListExpr* node) override;
   Result Visit(UIntConstant* node) override;
   Result Visit(UnaryOp* node) override;
   Result Default(ASTNode* node) override;
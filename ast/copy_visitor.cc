@@ -65,21 +65,23 @@ Result CopyVisitor::Visit(Initializer* node) {
   return Make<Initializer>(node->GetType(), argList);
 }
 
-Result CopyVisitor::Visit(IntConstant* node) {
-  return Make<IntConstant>(node->GetValue(), node->GetBits());
-}
+// Constants are immutable leaves, so the copy can share them with the original
+// tree. This keeps large initializer lists from being duplicated on every pass.
+Result CopyVisitor::Visit(IntConstant* node) { return node; }
 
-Result CopyVisitor::Visit(UIntConstant* node) {
-  return Make<UIntConstant>(node->GetValue(), node->GetBits());
-}
+Result CopyVisitor::Visit(UIntConstant* node) { return node; }
+
+Result CopyVisitor::Visit(FloatConstant* node) { return node; }
+
+Result CopyVisitor::Visit(DoubleConstant* node) { return node; }
 
-Result CopyVisitor::Visit(FloatConstant* node) { return Make<FloatConstant>(node->GetValue()); }
+Result CopyVisitor::Visit(BoolConstant* node) { return node; }
 
-Result CopyVisitor::Visit(DoubleConstant* node) { return Make<DoubleConstant>(node->GetValue()); }
+Result CopyVisitor::Visit(NullConstant* node) { return node; }
 
-Result CopyVisitor::Visit(BoolConstant* node) { return Make<BoolConstant>(node->GetValue()); }
+Result CopyVisitor::Visit(SpecConstant* node) { return node; }
 
-Result CopyVisitor::Visit(NullConstant* node) { return Make<NullConstant>(); }
+Result CopyVisitor::Visit(PackedListExpr* node) { return node; }
 
 Result CopyVisitor::Visit(Stmts* stmts) {
   auto* newStmts = Make<Stmts>();
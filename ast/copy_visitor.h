@@ -49,11 +49,13 @@ class CopyVisitor : public Visitor {
   Result        Visit(MethodCall* node) override;
   Result        Visit(UnresolvedNewExpr* node) override;
   Result        Visit(NullConstant* constant) override;
+  Result        Visit(PackedListExpr* node) override;
   Result        Visit(ReturnStatement* stmt) override;
   Result        Visit(LoadExpr* node) override;
   Result        Visit(RawToSmartPtr* node) override;
   Result        Visit(SliceExpr* node) override;
   Result        Visit(SmartToRawPtr* node) override;
+  Result        Visit(SpecConstant* node) override;
   Result        Visit(Stmts* stmts) override;
   Result        Visit(StoreStmt* node) override;
   Result        Visit(SwizzleExpr* node) override;
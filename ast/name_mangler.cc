@@ -35,6 +35,9 @@ std::string QualifiersToString(int qualifiers, std::string sep) {
   if (qualifiers & Type::Qualifier::HostWriteable) { result += "hostwriteable" + sep; }
   if (qualifiers & Type::Qualifier::Coherent) { result += "coherent" + sep; }
   if (qualifiers & Type::Qualifier::Unfilterable) { result += "unfilterable" + sep; }
+  if (qualifiers & Type::Qualifier::Dynamic) { result += "dynamic" + sep; }
+  if (qualifiers & Type::Qualifier::Indirect) { result += "indirect" + sep; }
+  if (qualifiers & Type::Qualifier::Workgroup) { result += "workgroup" + sep; }
   return result;
 }
 
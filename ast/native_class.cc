@@ -29,6 +29,7 @@ void AddNativeClass(std::string name, NativeClass id) {
 
 void InitNativeClasses() {
   AddNativeClass("None", NativeClass::None);
+  AddNativeClass("Atomic", NativeClass::Atomic);
   AddNativeClass("BindGroup", NativeClass::BindGroup);
   AddNativeClass("Buffer", NativeClass::Buffer);
   AddNativeClass("ColorOutput", NativeClass::ColorOutput);
@@ -42,6 +43,7 @@ void InitNativeClasses() {
   AddNativeClass("Image", NativeClass::Image);
   AddNativeClass("Math", NativeClass::Math);
   AddNativeClass("Queue", NativeClass::Queue);
+  AddNativeClass("RenderBundle", NativeClass::RenderBundle);
   AddNativeClass("RenderPass", NativeClass::RenderPass);
   AddNativeClass("RenderPipeline", NativeClass::RenderPipeline);
   AddNativeClass("SampleableTexture1D", NativeClass::SampleableTexture1D);
@@ -50,6 +52,7 @@ void InitNativeClasses() {
   AddNativeClass("SampleableTexture3D", NativeClass::SampleableTexture3D);
   AddNativeClass("SampleableTextureCube", NativeClass::SampleableTextureCube);
   AddNativeClass("Sampler", NativeClass::Sampler);
+  AddNativeClass("Subgroup", NativeClass::Subgroup);
   AddNativeClass("SwapChain", NativeClass::SwapChain);
   AddNativeClass("System", NativeClass::System);
   AddNativeClass("Texture1D", NativeClass::Texture1D);
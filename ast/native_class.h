@@ -23,6 +23,7 @@ namespace Toucan {
 
 enum class NativeClass {
   None,
+  Atomic,
   BindGroup,
   Buffer,
   ColorOutput,
@@ -36,6 +37,7 @@ enum class NativeClass {
   Image,
   Math,
   Queue,
+  RenderBundle,
   RenderPass,
   RenderPipeline,
   SampleableTexture1D,
@@ -44,6 +46,7 @@ enum class NativeClass {
   SampleableTexture3D,
   SampleableTextureCube,
   Sampler,
+  Subgroup,
   SwapChain,
   System,
   Texture1D,
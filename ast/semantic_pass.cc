@@ -18,6 +18,7 @@
 #include <stdarg.h>
 #include <string.h>
 
+#include <bit>
 #include <filesystem>
 #include <functional>
 #include <iostream>
@@ -138,6 +139,65 @@ Result SemanticPass::Visit(UnresolvedCastExpr* node) {
 
 Result SemanticPass::Visit(Data* node) { return node; }
 
+// Returns true if default-initializing a value of the given type stores a field's default value.
+static bool HasFieldDefaults(Type* type) {
+  type = type->GetUnqualifiedType();
+  if (type->IsArray()) { return HasFieldDefaults(static_cast<ArrayType*>(type)->GetElementType()); }
+  if (!type->IsClass()) { return false; }
+  for (auto classType = static_cast<ClassType*>(type); classType;
+       classType = classType->GetParent()) {
+    for (const auto& field : classType->GetFields()) {
+      if (field->defaultValue || HasFieldDefaults(field->type)) { return true; }
+    }
+  }
+  return false;
+}
+
+// Returns true if a value of the given type can be reinterpreted from raw bytes.
+static bool IsPlainOldData(Type* type) {
+  type = type->GetUnqualifiedType();
+  if (type->IsArray()) {
+    auto arrayType = static_cast<ArrayType*>(type);
+    return !arrayType->IsUnsizedArray() && IsPlainOldData(arrayType->GetElementType());
+  } else if (type->IsClass()) {
+    auto classType = static_cast<ClassType*>(type);
+    if (classType->IsNative() || classType->IsUnsizedClass()) { return false; }
+    for (; classType; classType = classType->GetParent()) {
+      for (const auto& field : classType->GetFields()) {
+        if (!IsPlainOldData(field->type)) { return false; }
+      }
+    }
+    return true;
+  }
+  // Only 0 and 1 are valid bools, so arbitrary file bytes are not.
+  if (type->IsBool() || type->IsBoolVector()) { return false; }
+  return type->IsInteger() || type->IsFloatingPoint() || type->IsVector() || type->IsMatrix();
+}
+
+Result SemanticPass::Visit(UnresolvedData* node) {
+  Type* type = ResolveType(node->GetType());
+  if (!type) { return nullptr; }
+  if (!type->IsArray()) {
+    return Error("inline() type %s is not an array type", type->ToString().c_str());
+  }
+  auto arrayType = static_cast<ArrayType*>(type);
+  Type* elementType = arrayType->GetElementType();
+  if (!IsPlainOldData(elementType)) {
+    return Error("cannot inline() data of element type %s", elementType->ToString().c_str());
+  }
+  Data*  data = node->GetData();
+  size_t size = data->GetSize();
+  // The element size is already rounded up to the element's alignment.
+  size_t elementSize = arrayType->GetElementSizeInBytes();
+  size_t arraySize = static_cast<size_t>(arrayType->GetSizeInBytes());
+  if (elementSize == 0 ||
+      (arrayType->IsUnsizedArray() ? size % elementSize : size != arraySize)) {
+    return Error("inline() file size of %zu bytes does not match type %s (element size %zu)",
+                 size, type->ToString().c_str(), elementSize);
+  }
+  return Make<Data>(data->GetBuffer(), size, arrayType);
+}
+
 Result SemanticPass::Visit(Decls* node) {
   Stmts* stmts = Make<Stmts>();
   for (auto decl : node->Get()) {
@@ -235,7 +295,7 @@ Stmt* SemanticPass::Initialize(Expr* dest, Expr* initExpr) {
     }
     initExpr = Widen(initExpr, type);
     return Make<StoreStmt>(dest, initExpr);
-  } else if (type->IsClass()) {
+  } else if (type->IsClass() && static_cast<ClassType*>(type)->GetTemplate() != NativeClass::Atomic) {
     return InitializeClass(dest, static_cast<ClassType*>(type));
   } else if (type->IsArray()) {
     auto arrayType = static_cast<ArrayType*>(type);
@@ -296,6 +356,26 @@ Result SemanticPass::Visit(VarDeclaration* decl) {
   
   currentAutoType_ = nullptr;
 
+  int qualifiers;
+  type->GetUnqualifiedType(&qualifiers);
+  if (qualifiers & Type::Qualifier::Workgroup) {
+    // Host code has no workgroup memory, so the variable must belong to device code.
+    constexpr int kDeviceCode = Method::Modifier::Vertex | Method::Modifier::Fragment |
+                                Method::Modifier::Compute | Method::Modifier::DeviceOnly;
+    if (!currentMethod_ || !(currentMethod_->modifiers & kDeviceCode)) {
+      return Error("workgroup variable \"%s\" must be declared in a shader or deviceonly method",
+                   id.c_str());
+    }
+    // Every invocation would run the initialization, racing on the shared memory.
+    if (initExpr) {
+      return Error("workgroup variable \"%s\" can not have an initializer", id.c_str());
+    }
+    if (HasFieldDefaults(type)) {
+      return Error("workgroup variable \"%s\" can not have a type with field default values",
+                   id.c_str());
+    }
+  }
+
   if (scopeStack_.Top()->IsClassDecl()) {
     auto classDecl = static_cast<ClassDecl*>(scopeStack_.Top());
     auto classType = classDecl->GetClass();
@@ -320,6 +400,8 @@ Result SemanticPass::Visit(VarDeclaration* decl) {
   }
   auto var = std::make_shared<Var>(id, type);
   scope->AppendVar(var);
+  // Workgroup memory is zero-initialized, and storing to it here would race.
+  if (qualifiers & Type::Qualifier::Workgroup) { return {}; }
   Expr* varExpr = Make<VarExpr>(var.get());
   return Initialize(varExpr, initExpr);
 }
@@ -336,6 +418,22 @@ Result SemanticPass::Visit(MethodDecl* decl) {
   method->stmts = decl->GetBody();
   method->initializer = decl->GetInitializer();
   method->workgroupSize = decl->GetWorkgroupSize();
+  for (int i = 0; i < 3; ++i) {
+    const std::string& id = decl->GetWorkgroupSizeOverrides()[i];
+    if (id.empty()) continue;
+    Expr* specConstant = classType->FindOverride(id);
+    if (!specConstant) {
+      return Error("workgroup size \"%s\" is not an override", id.c_str());
+    }
+    auto defaultValue = static_cast<SpecConstant*>(specConstant)->GetDefaultValue();
+    Type* type = defaultValue->GetType(types_);
+    if (!type->IsInt() && !type->IsUInt()) {
+      return Error("workgroup size override \"%s\" must be an int or uint", id.c_str());
+    }
+    ConstantFolder constantFolder(types_, &method->workgroupSize[i]);
+    constantFolder.Resolve(defaultValue);
+    method->workgroupSizeOverrides[i] = specConstant;
+  }
   if (!(decl->GetModifiers() & Method::Modifier::Static)) {
     Type* thisType = types_->GetQualifiedType(classType, decl->GetThisQualifiers());
     thisType = types_->GetRawPtrType(thisType);
@@ -355,7 +453,7 @@ Result SemanticPass::Visit(MethodDecl* decl) {
 
   bool isOverloaded = overloadedMethods_.contains(method->name);
   method->mangledName = GetMangledName(classDecl, decl, isOverloaded);
-  classType->AddMethod(method);
+  AddMethod(classType, method);
   return {};
 }
 
@@ -369,7 +467,21 @@ Result SemanticPass::Visit(ConstDecl* decl) {
 
   if (scopeStack_.Top()->IsClassDecl()) {
     auto classDecl = static_cast<ClassDecl*>(scopeStack_.Top());
-    classDecl->GetClass()->AddConstant(decl->GetID(), decl->GetExpr());
+    auto classType = classDecl->GetClass();
+    if (decl->IsOverride()) {
+      Type* type = expr->GetType(types_);
+      if (!type->IsBool() && !type->IsInt() && !type->IsUInt() && !type->IsFloat()) {
+        return Error("override \"%s\" must be a bool, int, uint or float", id.c_str());
+      }
+      // Each override takes the next SpecId, so a redefinition would alias an existing one.
+      if (classType->FindOverride(id)) {
+        return Error("override \"%s\" is already defined", id.c_str());
+      }
+      uint32_t specId = classType->GetNumOverrides();
+      classType->AddOverride(id, Make<SpecConstant>(id, specId, expr));
+      return {};
+    }
+    classType->AddConstant(decl->GetID(), decl->GetExpr());
     return {};
   }
 
@@ -437,6 +549,8 @@ Expr* SemanticPass::Widen(Expr* node, Type* dstType) {
     return node;
   } else if (node->IsUnresolvedListExpr()) {
     return ResolveListExpr(static_cast<UnresolvedListExpr*>(node)->GetArgList(), dstType);
+  } else if (node->IsPackedListExpr()) {
+    return ResolvePackedList(static_cast<PackedListExpr*>(node), dstType);
   } else if ((srcType->IsStrongPtr() || srcType->IsWeakPtr()) && dstType->IsRawPtr()) {
     return Make<SmartToRawPtr>(node);
   } else if (dstType->IsRawPtr() && static_cast<RawPtrType*>(dstType)->GetBaseType()->IsArray()) {
@@ -556,6 +670,43 @@ Expr* SemanticPass::ResolveListExpr(ArgList* argList, Type* dstType) {
   return Make<Initializer>(dstType, exprList);
 }
 
+// Returns the scalar element type if type is a padding-free nest of arrays,
+// vectors and matrices whose dimensions match shape, otherwise null.
+static Type* GetPackedElementType(Type* type, const std::vector<uint32_t>& shape, size_t dim = 0) {
+  type = type->GetUnqualifiedType();
+  if (dim == shape.size()) {
+    return type->IsFloat() || type->IsInt() || type->IsUInt() ? type : nullptr;
+  }
+  if (!type->IsArrayLike()) { return nullptr; }
+  auto arrayLikeType = static_cast<ArrayLikeType*>(type);
+  if (arrayLikeType->GetNumElements() != shape[dim]) { return nullptr; }
+  if (type->IsArray() && static_cast<ArrayType*>(type)->GetElementPadding() != 0) {
+    return nullptr;
+  }
+  return GetPackedElementType(arrayLikeType->GetElementType(), shape, dim + 1);
+}
+
+Expr* SemanticPass::ResolvePackedList(PackedListExpr* node, Type* dstType) {
+  Type* elementType = GetPackedElementType(dstType, node->GetShape());
+  if (!elementType || (node->IsFloat() && !elementType->IsFloat())) {
+    // Anything more exotic is resolved the slow way, one level at a time.
+    return ResolveListExpr(node->Expand(nodes_), dstType);
+  }
+  auto values = node->GetValues();
+  auto offset = node->GetOffset();
+  if (!node->IsFloat() && elementType->IsFloat()) {
+    size_t size = 1;
+    for (auto dim : node->GetShape()) { size *= dim; }
+    auto converted = std::make_shared<std::vector<uint32_t>>(size);
+    for (size_t i = 0; i < size; ++i) {
+      (*converted)[i] = std::bit_cast<uint32_t>(static_cast<float>(static_cast<int32_t>(node->GetValue(i))));
+    }
+    values = converted;
+    offset = 0;
+  }
+  return Make<PackedListExpr>(values, offset, node->GetShape(), elementType->IsFloat(), dstType);
+}
+
 Result SemanticPass::Visit(UnresolvedMethodCall* node) {
   std::string id = node->GetID();
   Expr*       expr = Resolve(node->GetExpr());
@@ -1017,7 +1168,7 @@ Result SemanticPass::Visit(ClassDecl* node) {
       destructor->mangledName = classType->GetName() + "_Destroy";
       destructor->AddFormalArg("this", types_->GetRawPtrType(classType), nullptr);
       destructor->stmts = Make<Stmts>();
-      classType->AddMethod(destructor);
+      AddMethod(classType, destructor);
     }
 
     if (destructor->stmts) {
@@ -1195,23 +1346,48 @@ Method* SemanticPass::FindMethod(Expr*               thisExpr,
                                  const std::string&  name,
                                  ArgList*            args,
                                  std::vector<Expr*>* newArgList) {
-  for (const auto& it : classType->GetMethods()) {
-    Method* m = it.get();
-    if (m->name == name) {
-      std::vector<Expr*> result;
-      if (MatchArgs(thisExpr, args, m, types_, &result)) {
-        *newArgList = result;
-        return m;
-      }
+  OverloadKey key{classType, name};
+  key.argTypes.push_back(thisExpr ? thisExpr->GetType(types_) : nullptr);
+  for (auto arg : args->GetArgs()) {
+    Expr* expr = arg->GetExpr();
+    key.argTypes.push_back(expr ? expr->GetType(types_) : nullptr);
+    if (args->IsNamed()) { key.argNames.push_back(arg->GetID()); }
+  }
+  auto i = overloadCache_.find(key);
+  // MatchArgs() is re-run on a hit, since it also resolves default args.
+  if (i != overloadCache_.end() && MatchArgs(thisExpr, args, i->second, types_, newArgList)) {
+    return i->second;
+  }
+  Method* method = FindMethodUncached(thisExpr, classType, name, args, newArgList);
+  if (method) { overloadCache_[key] = method; }
+  return method;
+}
+
+Method* SemanticPass::FindMethodUncached(Expr*               thisExpr,
+                                         ClassType*          classType,
+                                         const std::string&  name,
+                                         ArgList*            args,
+                                         std::vector<Expr*>* newArgList) {
+  for (Method* m : classType->FindMethods(name)) {
+    std::vector<Expr*> result;
+    if (MatchArgs(thisExpr, args, m, types_, &result)) {
+      *newArgList = result;
+      return m;
     }
   }
   if (classType->GetParent()) {
-    return FindMethod(thisExpr, classType->GetParent(), name, args, newArgList);
+    return FindMethodUncached(thisExpr, classType->GetParent(), name, args, newArgList);
   } else {
     return nullptr;
   }
 }
 
+void SemanticPass::AddMethod(ClassType* classType, Method* method) {
+  classType->AddMethod(method);
+  // A new method may be a better (earlier) match for a previously-seen call.
+  overloadCache_.clear();
+}
+
 static bool MatchAllButFirst(const VarVector& v1, const VarVector& v2) {
   if (v1.size() != v2.size()) { return false; }
 
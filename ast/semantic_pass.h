@@ -17,6 +17,7 @@
 
 #include "copy_visitor.h"
 
+#include <unordered_map>
 #include <unordered_set>
 
 namespace Toucan {
@@ -28,6 +29,26 @@ struct TypeLocationPair {
 
 using TypeLocationList = std::vector<TypeLocationPair>;
 
+// Memoizes overload resolution: a method call site is identified by the
+// class searched, the method name, and the types (and names, if any) of the
+// receiver and arguments.
+struct OverloadKey {
+  ClassType*               classType;
+  std::string              name;
+  std::vector<Type*>       argTypes;
+  std::vector<std::string> argNames;
+  bool operator==(const OverloadKey& other) const = default;
+};
+
+struct OverloadKeyHash {
+  size_t operator()(const OverloadKey& key) const {
+    size_t hash = std::hash<ClassType*>()(key.classType) ^ std::hash<std::string>()(key.name);
+    for (auto type : key.argTypes) { hash = hash * 31 + std::hash<Type*>()(type); }
+    for (const auto& name : key.argNames) { hash = hash * 31 + std::hash<std::string>()(name); }
+    return hash;
+  }
+};
+
 class SemanticPass : public CopyVisitor {
  public:
   SemanticPass(NodeVector* nodes, TypeTable* types);
@@ -59,6 +80,7 @@ class SemanticPass : public CopyVisitor {
   Result Visit(ClassTemplateDecl* node) override;
   Result Visit(ClassTemplateInstance* node) override;
   Result Visit(Data* expr) override;
+  Result Visit(UnresolvedData* expr) override;
   Result Visit(Decls* decls) override;
   Result Visit(DoStatement* stmt) override;
   Result Visit(EnumDecl* decls) override;
@@ -98,6 +120,7 @@ class SemanticPass : public CopyVisitor {
   Expr*   MakeDefaultInitializer(Type* type);
   void    AddDefaultInitializers(Type* type, std::vector<Expr*>* exprs);
   Expr*   ResolveListExpr(ArgList* argList, Type* dstType);
+  Expr*   ResolvePackedList(PackedListExpr* node, Type* dstType);
   void    WidenArgList(std::vector<Expr*>& argList, const VarVector& formalArgList);
   Expr*   Widen(Expr* expr, Type* dstType);
   Expr*   MakeIndexable(Expr* expr);
@@ -113,6 +136,12 @@ class SemanticPass : public CopyVisitor {
                      const std::string&  name,
                      ArgList*            args,
                      std::vector<Expr*>* newArgList);
+  Method* FindMethodUncached(Expr*               thisExpr,
+                             ClassType*          classType,
+                             const std::string&  name,
+                             ArgList*            args,
+                             std::vector<Expr*>* newArgList);
+  void    AddMethod(ClassType* classType, Method* method);
   Method* FindOverriddenMethod(ClassType* classType, Method* method);
   bool             ResolveTypeList(ASTTypeList* typeList, TypeList* result);
   ClassType*       GetOrCreateClassType(ClassDecl* decl);
@@ -130,6 +159,7 @@ class SemanticPass : public CopyVisitor {
   TypeMap          currentTemplateArgs_;
   Type*            currentAutoType_ = nullptr;
   std::unordered_set<std::string>  overloadedMethods_;
+  std::unordered_map<OverloadKey, Method*, OverloadKeyHash> overloadCache_;
 };
 
 };  // namespace Toucan
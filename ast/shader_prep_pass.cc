@@ -20,6 +20,12 @@ namespace Toucan {
 
 namespace {
 
+bool IsStorageTexture(ClassType* classType) {
+  auto templ = classType->GetTemplate();
+  return templ == NativeClass::Texture1D || templ == NativeClass::Texture2D ||
+         templ == NativeClass::Texture2DArray || templ == NativeClass::Texture3D;
+}
+
 // If true, this type can be used for formal parameters and local variables.
 // If false, this type most be resolved to a global during this pass.
 bool IsValidLocalVar(Type* type) {
@@ -180,6 +186,9 @@ Type* ShaderPrepPass::ConvertType(Type* type) {
         return types_->GetVector(type, 4);
       } else if (classType->GetTemplate() == NativeClass::BindGroup) {
         return classType->GetTemplateArgs()[0];
+      } else if (IsStorageTexture(classType)) {
+        // Keep the readonly/writeonly qualifiers; they become the image's access decorations.
+        return types_->GetQualifiedType(type, qualifiers);
       }
     }
   }
@@ -341,6 +350,7 @@ Method* ShaderPrepPass::Run(Method* entryPoint) {
   entryPointWrapper_ = std::make_unique<Method>(entryPoint->modifiers, types_->GetVoid(), "main",
                                                 entryPoint->classType);
   entryPointWrapper_->workgroupSize = entryPoint->workgroupSize;
+  entryPointWrapper_->workgroupSizeOverrides = entryPoint->workgroupSizeOverrides;
   if (inputs) {
     Expr* input = CreateAndLoadInputVars(inputs->type);
     newArgs->Append(input);
@@ -25,6 +25,7 @@ namespace Toucan {
 ShaderValidationPass::ShaderValidationPass() {}
 
 void ShaderValidationPass::Run(Method* method) {
+  methodModifiers_ = method->modifiers;
   if (method->stmts) Visit(method->stmts);
 }
 
@@ -66,6 +67,8 @@ Result ShaderValidationPass::Visit(IntConstant* node) { return {}; }
 
 Result ShaderValidationPass::Visit(UIntConstant* node) { return {}; }
 
+Result ShaderValidationPass::Visit(SpecConstant* node) { return {}; }
+
 Result ShaderValidationPass::Visit(DoubleConstant* node) { return {}; }
  
 Result ShaderValidationPass::Visit(FloatConstant* node) { return {}; }
@@ -89,6 +92,8 @@ Result ShaderValidationPass::Visit(BoolConstant* node) { return {}; }
 
 Result ShaderValidationPass::Visit(NullConstant* node) { return {}; }
 
+Result ShaderValidationPass::Visit(PackedListExpr* node) { return {}; }
+
 Result ShaderValidationPass::Visit(Stmts* stmts) {
   for (Stmt* const& it : stmts->GetStmts()) {
     Resolve(it);
@@ -114,7 +119,16 @@ Result ShaderValidationPass::Visit(LoadExpr* node) {
 }
 
 Result ShaderValidationPass::Visit(MethodCall* node) {
+  Method* method = node->GetMethod();
+  if (method->classType->GetNativeClass() == NativeClass::Subgroup && method->name == "Broadcast") {
+    Expr* id = node->GetArgList()->Get()[1];
+    if (!id->IsIntConstant() && !id->IsUIntConstant()) {
+      Error(node, "Subgroup.Broadcast() requires a constant invocation id");
+    }
+  }
   Resolve(node->GetArgList());
+  // Callees are compiled into the shader too, so check each reachable body once.
+  if (method->stmts && visitedMethods_.insert(method).second) { Resolve(method->stmts); }
   return {};
 }
 
@@ -205,6 +219,16 @@ Result ShaderValidationPass::Visit(ToRawArray* node) {
 }
 
 Result ShaderValidationPass::Visit(VarExpr* node) {
+  Var* var = node->GetVar();
+  int  qualifiers;
+  var->type->GetUnqualifiedType(&qualifiers);
+  if (qualifiers & Type::Qualifier::Workgroup && !(methodModifiers_ & Method::Modifier::Compute)) {
+    // Report each variable once, at its first use (normally its declaration).
+    if (workgroupVarErrors_.insert(var).second) {
+      Error(node, "workgroup variable \"%s\" is only allowed in compute shaders",
+            var->name.c_str());
+    }
+  }
   return {};
 }
 
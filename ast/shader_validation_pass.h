@@ -15,6 +15,8 @@
 #ifndef _AST_AST_SHADER_VALIDATION_PASS_H_
 #define _AST_AST_SHADER_VALIDATION_PASS_H_
 
+#include <unordered_set>
+
 #include "ast.h"
 
 namespace Toucan {
@@ -45,11 +47,13 @@ class ShaderValidationPass : public Visitor {
   Result            Visit(IntConstant* constant) override;
   Result            Visit(MethodCall* node) override;
   Result            Visit(NullConstant* constant) override;
+  Result            Visit(PackedListExpr* node) override;
   Result            Visit(RawToSmartPtr* node) override;
   Result            Visit(ReturnStatement* stmt) override;
   Result            Visit(LoadExpr* node) override;
   Result            Visit(SmartToRawPtr* node) override;
   Result            Visit(SliceExpr* node) override;
+  Result            Visit(SpecConstant* node) override;
   Result            Visit(Stmts* stmts) override;
   Result            Visit(StoreStmt* node) override;
   Result            Visit(SwizzleExpr* node) override;
@@ -65,8 +69,11 @@ class ShaderValidationPass : public Visitor {
   int               GetNumErrors() const { return numErrors_; }
 
  private:
-  Result       Resolve(ASTNode* node);
-  int          numErrors_ = 0;
+  Result                    Resolve(ASTNode* node);
+  int                       numErrors_ = 0;
+  int                       methodModifiers_ = 0;
+  std::unordered_set<Var*>  workgroupVarErrors_;
+  std::unordered_set<Method*> visitedMethods_;
 };
 
 };  // namespace Toucan
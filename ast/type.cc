@@ -26,7 +26,7 @@ namespace Toucan {
 namespace {
 
 constexpr int kNonRemovableQualifiers = Type::Qualifier::ReadOnly | Type::Qualifier::WriteOnly;
-constexpr int kNonAddableQualifiers = Type::Qualifier::Uniform | Type::Qualifier::Storage | Type::Qualifier::Vertex | Type::Qualifier::Index | Type::Qualifier::Sampleable | Type::Qualifier::Renderable | Type::Qualifier::HostReadable | Type::Qualifier::HostWriteable;
+constexpr int kNonAddableQualifiers = Type::Qualifier::Uniform | Type::Qualifier::Storage | Type::Qualifier::Vertex | Type::Qualifier::Index | Type::Qualifier::Sampleable | Type::Qualifier::Renderable | Type::Qualifier::HostReadable | Type::Qualifier::HostWriteable | Type::Qualifier::Dynamic | Type::Qualifier::Indirect;
 
 inline int roundUpTo(int modulus, int value) { return (value + modulus - 1) / modulus * modulus; }
 
@@ -44,6 +44,9 @@ std::string QualifiersToString(int qualifiers, std::string sep) {
   if (qualifiers & Type::Qualifier::HostWriteable) { result += "hostwriteable" + sep; }
   if (qualifiers & Type::Qualifier::Coherent) { result += "coherent" + sep; }
   if (qualifiers & Type::Qualifier::Unfilterable) { result += "unfilterable" + sep; }
+  if (qualifiers & Type::Qualifier::Dynamic) { result += "dynamic" + sep; }
+  if (qualifiers & Type::Qualifier::Indirect) { result += "indirect" + sep; }
+  if (qualifiers & Type::Qualifier::Workgroup) { result += "workgroup" + sep; }
   return result;
 }
 
@@ -54,6 +57,15 @@ bool CheckQualifiers(int src, int dst) {
          (src & dstNonAddable) == dstNonAddable;
 }
 
+// Returns the offset just past the last of "fields", laid out in order starting at "offset".
+size_t EndOfFields(size_t offset, const std::vector<Field*>& fields) {
+  for (Field* field : fields) {
+    offset = roundUpTo(field->type->GetAlignmentInBytes(), offset);
+    offset += field->type->GetSizeInBytes();
+  }
+  return offset;
+}
+
 }  // namespace
 
 Type* Type::CheckAndRemoveQualifiers(Type* other) const {
@@ -362,7 +374,9 @@ void ClassType::SetParent(ClassType* parent) {
 
 Field* ClassType::AddField(std::string name, Type* type, Expr* defaultValue) {
   fields_.push_back(std::make_unique<Field>(name, type, numFields_, this, defaultValue));
+  layout_.push_back(fields_.back().get());
   numFields_++;
+  fieldMap_.emplace(name, fields_.back().get());
   return fields_.back().get();
 }
 
@@ -370,6 +384,12 @@ void ClassType::AddConstant(const std::string id, Expr* expr) {
   constants_[id] = expr;
 }
 
+// Overrides are also constants, so that they resolve by name like any other class constant.
+void ClassType::AddOverride(const std::string id, Expr* expr) {
+  constants_[id] = expr;
+  overrides_[id] = expr;
+}
+
 void ClassType::SetMemoryLayout(MemoryLayout memoryLayout, TypeTable* types) {
   if (memoryLayout_ >= memoryLayout) { return; }
   memoryLayout_ = memoryLayout;
@@ -384,11 +404,43 @@ void ClassType::SetMemoryLayout(MemoryLayout memoryLayout, TypeTable* types) {
   }
 }
 
+// Lays out fields starting at "offset" in order of decreasing alignment, which reduces the
+// padding between them.  An unsized array must remain last.  The declaration order is kept
+// unless the fields then end at a smaller aligned offset.
+void ClassType::ReorderFields(size_t offset) {
+  int    alignment = GetAlignmentInBytes();
+  size_t declaredEnd = roundUpTo(alignment, EndOfFields(offset, layout_));
+  std::stable_sort(layout_.begin(), layout_.end(), [](Field* a, Field* b) {
+    if (a->type->IsUnsizedArray() != b->type->IsUnsizedArray()) {
+      return b->type->IsUnsizedArray();
+    }
+    return a->type->GetAlignmentInBytes() > b->type->GetAlignmentInBytes();
+  });
+  size_t reorderedEnd = roundUpTo(alignment, EndOfFields(offset, layout_));
+  if (reorderedEnd < declaredEnd) {
+    bytesSaved_ = declaredEnd - reorderedEnd;
+  } else {
+    bytesSaved_ = 0;
+    for (size_t i = 0; i < fields_.size(); ++i) { layout_[i] = fields_[i].get(); }
+  }
+}
+
 size_t ClassType::ComputeFieldOffsets() {
   size_t offset = 0;
   if (parent_) { offset = parent_->ComputeFieldOffsets(); }
+  // The size of a nested class depends on its own layout, so compute that first.
+  for (const auto& field : fields_) {
+    Type* type = field->type->GetUnqualifiedType();
+    while (type->IsArray()) {
+      type = static_cast<ArrayType*>(type)->GetElementType()->GetUnqualifiedType();
+    }
+    if (type->IsClass()) { static_cast<ClassType*>(type)->ComputeFieldOffsets(); }
+  }
+  for (size_t i = 0; i < fields_.size(); ++i) { layout_[i] = fields_[i].get(); }
+  if (reorderFields_) { ReorderFields(offset); }
   Field* prevField = nullptr;
-  for (const auto& field : GetFields()) {
+  int    layoutIndex = numFields_ - fields_.size();
+  for (Field* field : layout_) {
     size_t size = field->type->GetSizeInBytes();
     size_t alignment = field->type->GetAlignmentInBytes();
     if (size_t padding = offset % alignment) {
@@ -396,8 +448,9 @@ size_t ClassType::ComputeFieldOffsets() {
       prevField->padding = padding;
     }
     field->offset = offset;
+    field->layoutIndex = layoutIndex++;
     offset += size;
-    prevField = field.get();
+    prevField = field;
   }
   padding_ = GetSizeInBytes(0) - offset;
   return offset;
@@ -405,9 +458,16 @@ size_t ClassType::ComputeFieldOffsets() {
 
 void ClassType::AddMethod(Method* method) {
   methods_.push_back(std::unique_ptr<Method>(method));
+  methodMap_[method->name].push_back(method);
   if (method->IsDestructor()) destructor_ = method;
 }
 
+const std::vector<Method*>& ClassType::FindMethods(const std::string& name) const {
+  static const std::vector<Method*> empty;
+  auto i = methodMap_.find(name);
+  return i != methodMap_.end() ? i->second : empty;
+}
+
 Type* ClassType::FindType(const std::string& id) {
   if (Type* type = types_[id]) { return type; }
   return parent_ ? parent_->FindType(id) : nullptr;
@@ -418,11 +478,19 @@ Expr* ClassType::FindConstant(const std::string& id) {
   return parent_ ? parent_->FindConstant(id) : nullptr;
 }
 
-Field* ClassType::FindField(std::string name) const {
-  for (const auto& it : fields_) {
-    Field* field = it.get();
-    if (field->name == name) { return field; }
-  }
+Expr* ClassType::FindOverride(const std::string& id) {
+  auto it = overrides_.find(id);
+  if (it != overrides_.end()) { return it->second; }
+  return parent_ ? parent_->FindOverride(id) : nullptr;
+}
+
+int ClassType::GetNumOverrides() const {
+  return overrides_.size() + (parent_ ? parent_->GetNumOverrides() : 0);
+}
+
+Field* ClassType::FindField(const std::string& name) const {
+  auto i = fieldMap_.find(name);
+  if (i != fieldMap_.end()) { return i->second; }
   return parent_ ? parent_->FindField(name) : nullptr;
 }
 
@@ -432,6 +500,8 @@ int ClassType::GetSizeInBytes() const {
 }
 
 int ClassType::GetAlignmentInBytes() const {
+  // Atomics are laid out exactly like the integer they wrap.
+  if (template_ == NativeClass::Atomic) { return templateArgs_[0]->GetAlignmentInBytes(); }
   int result = parent_ ? parent_->GetAlignmentInBytes() : 1;
   for (const auto& it : fields_) {
     result = std::max(result, it->type->GetAlignmentInBytes());
@@ -441,8 +511,9 @@ int ClassType::GetAlignmentInBytes() const {
 }
 
 int ClassType::GetSizeInBytes(int dynamicArrayLength) const {
+  if (template_ == NativeClass::Atomic) { return templateArgs_[0]->GetSizeInBytes(); }
   int size = parent_ ? parent_->GetSizeInBytes() : 0;
-  for (const auto& it : fields_) {
+  for (const auto& it : layout_) {
     size += it->type->GetSizeInBytes(dynamicArrayLength);
     size = roundUpTo(it->type->GetAlignmentInBytes(), size);
   }
@@ -558,6 +629,7 @@ TypeTable::TypeTable() {
 }
 
 IntegerType* TypeTable::GetInteger(int bits, bool isSigned) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   int          key = isSigned ? -bits : bits;
   IntegerType* type = integerTypes_[key];
   if (type == nullptr) {
@@ -568,6 +640,7 @@ IntegerType* TypeTable::GetInteger(int bits, bool isSigned) {
 }
 
 FloatingPointType* TypeTable::GetFloatingPoint(int bits) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   FloatingPointType* type = floatingPointTypes_[bits];
   if (type == nullptr) {
     type = Make<FloatingPointType>(bits);
@@ -596,6 +669,7 @@ BoolType* TypeTable::GetBool() { return bool_; }
 
 VectorType* TypeTable::GetVector(Type* componentType, int size) {
   if (size < 2 || size > 4) return nullptr;
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   VectorType* type = vectorTypes_[TypeAndInt(componentType, size)];
   if (type == nullptr) {
     type = Make<VectorType>(componentType, size);
@@ -606,6 +680,7 @@ VectorType* TypeTable::GetVector(Type* componentType, int size) {
 
 MatrixType* TypeTable::GetMatrix(VectorType* columnType, int numColumns) {
   if (numColumns < 2 || numColumns > 4) return nullptr;
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   MatrixType* type = matrixTypes_[TypeAndInt(columnType, numColumns)];
   if (type == nullptr) {
     type = Make<MatrixType>(columnType, numColumns);
@@ -625,15 +700,23 @@ ListType* TypeTable::GetList(VarVector&& types) {
     }
     return true;
   };
-  for (auto type : listTypes_) {
-    if (matchVarVectors(type->GetTypes(), types)) { return type; }
+  size_t hash = types.size();
+  for (const auto& var : types) {
+    hash = hash * 31 + std::hash<std::string>()(var->name);
+    hash = hash * 31 + std::hash<Type*>()(var->type);
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  auto range = listTypes_.equal_range(hash);
+  for (auto i = range.first; i != range.second; ++i) {
+    if (matchVarVectors(i->second->GetTypes(), types)) { return i->second; }
   }
   auto type = Make<ListType>(types);
-  listTypes_.push_back(type);
+  listTypes_.emplace(hash, type);
   return type;
 }
 
 StrongPtrType* TypeTable::GetStrongPtrType(Type* baseType) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   StrongPtrType* type = strongPtrTypes_[baseType];
   if (type == nullptr) {
     type = Make<StrongPtrType>(baseType);
@@ -643,6 +726,7 @@ StrongPtrType* TypeTable::GetStrongPtrType(Type* baseType) {
 }
 
 WeakPtrType* TypeTable::GetWeakPtrType(Type* baseType) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   WeakPtrType* type = weakPtrTypes_[baseType];
   if (type == nullptr) {
     type = Make<WeakPtrType>(baseType);
@@ -653,6 +737,7 @@ WeakPtrType* TypeTable::GetWeakPtrType(Type* baseType) {
 
 RawPtrType* TypeTable::GetRawPtrType(Type* baseType) {
   assert(baseType);
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   RawPtrType* type = rawPtrTypes_[baseType];
   if (type == nullptr) {
     type = Make<RawPtrType>(baseType);
@@ -662,6 +747,7 @@ RawPtrType* TypeTable::GetRawPtrType(Type* baseType) {
 }
 
 ArrayType* TypeTable::GetArrayType(Type* elementType, int size, MemoryLayout memoryLayout) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   ArrayTypeKey key(TypeAndInt(elementType, size), memoryLayout);
   ArrayType*   type = arrayTypes_[key];
   if (type == nullptr) {
@@ -676,6 +762,7 @@ Type* TypeTable::GetQualifiedType(Type* type, int qualifiers) {
   int currentQualifiers;
   type = type->GetUnqualifiedType(&currentQualifiers);
   qualifiers |= currentQualifiers;
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   TypeAndInt key(type, qualifiers);
   if (auto result = qualifiedTypes_[key]) { return result; }
   QualifiedType* result = Make<QualifiedType>(type, qualifiers);
@@ -702,7 +789,18 @@ bool TypeTable::MatrixVector(Type* lhs, Type* rhs) {
 
 bool TypeTable::VectorMatrix(Type* lhs, Type* rhs) { return MatrixVector(rhs, lhs); }
 
-void TypeTable::ComputeFieldOffsets() {
+// If reorderFields is set, user classes stored in uniform or storage buffers may have their
+// fields reordered to minimize padding.  Host and device code both follow the reordered layout.
+void TypeTable::ComputeFieldOffsets(bool reorderFields) {
+  if (reorderFields) {
+    for (auto type : types_) {
+      if (!type->IsClass()) { continue; }
+      auto classType = static_cast<ClassType*>(type);
+      if (!classType->IsNative() && classType->GetMemoryLayout() != MemoryLayout::Default) {
+        classType->SetFieldReordering(true);
+      }
+    }
+  }
   for (auto type : types_) {
     type = type->GetUnqualifiedType();
     if (type->IsClass()) {
@@ -711,4 +809,14 @@ void TypeTable::ComputeFieldOffsets() {
   }
 }
 
+void TypeTable::PrintFieldReorderingReport(FILE* file) {
+  for (auto type : types_) {
+    if (!type->IsClass()) { continue; }
+    auto classType = static_cast<ClassType*>(type);
+    if (!classType->GetFieldReordering()) { continue; }
+    fprintf(file, "%s: %d bytes, %d saved by field reordering\n", classType->ToString().c_str(),
+            classType->GetSizeInBytes(0), classType->GetBytesSavedByReordering());
+  }
+}
+
 };  // namespace Toucan
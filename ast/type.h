@@ -22,6 +22,7 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <unordered_map>
@@ -100,6 +101,9 @@ class Type {
     HostWriteable = 0x200,
     Unfilterable = 0x0400,
     Coherent = 0x0800,
+    Dynamic = 0x1000,
+    Indirect = 0x2000,
+    Workgroup = 0x4000,
   };
 };
 
@@ -247,7 +251,7 @@ class QualifiedType : public Type {
 
 struct Field {
   Field(std::string n, Type* t, int i, ClassType* c, Expr* d)
-      : name(n), type(t), index(i), classType(c), defaultValue(d) {}
+      : name(n), type(t), index(i), classType(c), defaultValue(d), layoutIndex(i) {}
   std::string name;
   Type*       type;
   int         index;
@@ -255,6 +259,7 @@ struct Field {
   Expr*       defaultValue;
   size_t      offset = 0;
   size_t      padding = 0;
+  int         layoutIndex;  // position in memory; differs from index if fields are reordered
 };
 
 typedef std::vector<std::unique_ptr<Field>> FieldVector;
@@ -282,6 +287,7 @@ struct Method {
   std::string             name;
   ClassType*              classType;
   std::array<uint32_t, 3> workgroupSize = {1, 1, 1};
+  std::array<Expr*, 3>    workgroupSizeOverrides = {};  // SpecConstants, or null for literals
   VarVector               formalArgList;
   std::vector<Expr*>      defaultArgs;
   Stmts*                  stmts = nullptr;
@@ -305,12 +311,17 @@ class ClassType : public Type {
  public:
   ClassType(std::string name);
   Field*              AddField(std::string name, Type* type, Expr* defaultValue);
-  Field*              FindField(std::string name) const;
+  Field*              FindField(const std::string& name) const;
   void                AddConstant(std::string name, Expr* value);
   Expr*               FindConstant(const std::string& name);
+  void                AddOverride(std::string name, Expr* value);
+  Expr*               FindOverride(const std::string& name);
+  int                 GetNumOverrides() const;  // includes inherited overrides
   void                AddMethod(Method* method);
+  const std::vector<Method*>& FindMethods(const std::string& name) const;
   size_t              ComputeFieldOffsets();
   const FieldVector&  GetFields() const { return fields_; }          // local fields only
+  const std::vector<Field*>& GetFieldsInLayoutOrder() const { return layout_; }  // local only
   int                 GetTotalFields() const { return numFields_; }  // includes inherited fields
   const ExprMap&      GetConstants() const { return constants_; }
   const MethodVector& GetMethods() { return methods_; }
@@ -339,16 +350,24 @@ class ClassType : public Type {
   void                        SetMemoryLayout(MemoryLayout memoryLayout) { memoryLayout_ = memoryLayout; }
   MemoryLayout                GetMemoryLayout() const { return memoryLayout_; }
   int                         GetPadding() const { return padding_; }
+  void                        SetFieldReordering(bool reorder) { reorderFields_ = reorder; }
+  bool                        GetFieldReordering() const { return reorderFields_; }
+  int                         GetBytesSavedByReordering() const { return bytesSaved_; }
   bool                        NeedsDestruction() const override;
   bool                        ContainsRawPtr() const override;
 
  private:
+  void                 ReorderFields(size_t offset);
   std::string          name_;
   ClassType*           parent_ = nullptr;
   FieldVector          fields_;
+  std::vector<Field*>  layout_;
   MethodVector         methods_;
+  std::unordered_map<std::string, Field*>               fieldMap_;
+  std::unordered_map<std::string, std::vector<Method*>> methodMap_;
   TypeMap              types_;
   ExprMap              constants_;
+  ExprMap              overrides_;
   NativeClass          nativeClass_ = NativeClass::None;
   NativeClass          template_ = NativeClass::None;
   TypeList             templateArgs_;
@@ -356,6 +375,8 @@ class ClassType : public Type {
   int                  numFields_ = 0;  // includes inherited fields
   MemoryLayout         memoryLayout_ = MemoryLayout::Default;
   int                  padding_ = 0;
+  bool                 reorderFields_ = false;
+  int                  bytesSaved_ = 0;
 };
 
 class PtrType : public Type {
@@ -425,6 +446,7 @@ class TypeTable {
   TypeTable();
   template <typename T, typename... ARGS>
   T* Make(ARGS&&... args) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     T* type = new T(std::forward<ARGS>(args)...);
     typesStorage_.push_back(std::unique_ptr<T>(type));
     types_.push_back(type);
@@ -456,7 +478,8 @@ class TypeTable {
   static bool ScalarMatrix(Type* lhs, Type* rhs);
   static bool MatrixVector(Type* lhs, Type* rhs);
   static bool VectorMatrix(Type* lhs, Type* rhs);
-  void        ComputeFieldOffsets();
+  void        ComputeFieldOffsets(bool reorderFields = false);
+  void        PrintFieldReorderingReport(FILE* file);
   const TypeVector& GetTypes() { return types_; }
 
  private:
@@ -471,9 +494,11 @@ class TypeTable {
   std::unordered_map<TypeAndInt, VectorType*>          vectorTypes_;
   std::unordered_map<TypeAndInt, MatrixType*>          matrixTypes_;
   std::unordered_map<TypeAndInt, QualifiedType*>       qualifiedTypes_;
-  std::vector<ListType*>                               listTypes_;
+  std::unordered_multimap<size_t, ListType*>           listTypes_;
   BoolType*                                            bool_;
   VoidType*                                            void_;
+  // Shader code generation runs on several threads, each of which may intern new types.
+  std::recursive_mutex                                 mutex_;
 };
 
 };  // namespace Toucan
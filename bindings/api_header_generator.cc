@@ -39,6 +39,9 @@ std::string QualifiersToString(int qualifiers, std::string sep) {
   if (qualifiers & Type::Qualifier::HostWriteable) { result += "hostwriteable" + sep; }
   if (qualifiers & Type::Qualifier::Coherent) { result += "coherent" + sep; }
   if (qualifiers & Type::Qualifier::Unfilterable) { result += "unfilterable" + sep; }
+  if (qualifiers & Type::Qualifier::Dynamic) { result += "dynamic" + sep; }
+  if (qualifiers & Type::Qualifier::Indirect) { result += "indirect" + sep; }
+  if (qualifiers & Type::Qualifier::Workgroup) { result += "workgroup" + sep; }
   return result;
 }
 
@@ -245,6 +248,13 @@ Result APIHeaderGenerator::Visit(ConstDecl* node) {
 Result APIHeaderGenerator::Visit(MethodDecl* node) {
   if (!emitMethods_) return {};
   if (node->GetModifiers() & Method::Modifier::DeviceOnly) return {};
+  // Methods passing a template argument by value (e.g., Atomic<T>) are generated inline by the
+  // compiler and have no native entry point.
+  if (node->GetReturnType()->GetUnqualifiedType()->IsFormalTemplateArg()) return {};
+  for (auto& arg : node->GetFormalArguments()->GetStmts()) {
+    auto varDecl = static_cast<VarDeclaration*>(arg);
+    if (varDecl->GetType()->GetUnqualifiedType()->IsFormalTemplateArg()) return {};
+  }
   auto className = currentClassDecl_->GetName();
   bool isConstructor = node->GetID() == className;
   bool hasThisPtr = !(node->GetModifiers() & Method::Modifier::Static) && !isConstructor;
@@ -208,6 +208,7 @@ void GenBindings::EmitClass(ClassType* classType) {
 
   file_ << "  c->SetMemoryLayout(MemoryLayout::" <<
     MemoryLayoutToString(classType->GetMemoryLayout()) << ");\n";
+  if (classType->GetFieldReordering()) { file_ << "  c->SetFieldReordering(true);\n"; }
   if (ClassType* parent = classType->GetParent()) {
     int parentID = EmitType(classType->GetParent());
     file_ << "  c->SetParent(type" << parentID << ");\n";
@@ -223,7 +224,10 @@ void GenBindings::EmitClass(ClassType* classType) {
     }
     file_ << ");\n";
   }
+  // Only shader entry points are inspected at runtime, and only those reached
+  // by a pipeline constructor have code. Everything else is dead here.
   for (const auto& method : classType->GetMethods()) {
+    if (method->spirv.empty() && method->wgsl.empty()) { continue; }
     EmitMethod(method.get());
   }
 }
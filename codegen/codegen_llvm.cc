@@ -14,8 +14,13 @@
 
 #include "codegen_llvm.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <sstream>
 #include <span>
+#include <thread>
+#include <unordered_set>
 
 #include <llvm/IR/CallingConv.h>
 #include <llvm/IR/Constants.h>
@@ -37,6 +42,24 @@ namespace {
 
 constexpr int kMinAutoConstantSize = 1024;
 
+// Calls fn(i) for each i in [0, count), spread over at most numThreads threads.
+template <typename F>
+void ParallelFor(size_t count, unsigned numThreads, F fn) {
+  numThreads = static_cast<unsigned>(std::min<size_t>(numThreads, count));
+  if (numThreads <= 1) {
+    for (size_t i = 0; i < count; ++i) { fn(i); }
+    return;
+  }
+  std::atomic<size_t> next = 0;
+  auto                worker = [&]() {
+    for (size_t i = next++; i < count; i = next++) { fn(i); }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < numThreads; ++i) { threads.emplace_back(worker); }
+  worker();
+  for (auto& thread : threads) { thread.join(); }
+}
+
 struct Intrinsic {
     const char*         methodName;
     llvm::Intrinsic::ID id;
@@ -153,6 +176,11 @@ CodeGenLLVM::CodeGenLLVM(llvm::LLVMContext*                 context,
       builder_(builder),
       fpm_(fpm),
       debugOutput_(false) {
+#if defined(__EMSCRIPTEN__)
+  shaderThreads_ = 1;
+#else
+  shaderThreads_ = std::thread::hardware_concurrency();
+#endif
   boolType_ = llvm::Type::getInt1Ty(*context_);
   intType_ = llvm::Type::getInt32Ty(*context_);
   floatType_ = llvm::Type::getFloatTy(*context_);
@@ -176,20 +204,32 @@ void CodeGenLLVM::Run(Stmts* stmts) {
     pendingMethods_.pop_front();
     GenCodeForMethod(m);
   }
-  // Generate SPIR-V for shader entry points.
-  // An iterator can't be used here, since new types may be added (but won't need codegen).
-  int size = types_->GetTypes().size();
-  for (int i = 0; i < size; ++i) {
-    Type* type = types_->GetTypes()[i];
-    if (type->IsClass()) {
-      ClassType* classType = static_cast<ClassType*>(type);
-      for (const auto& method : classType->GetMethods()) {
+  // Generate SPIR-V for the shader entry points of pipelines which are actually
+  // constructed from host code. Shaders on any other class are unreachable.
+  std::unordered_set<Method*> seen;
+  std::vector<Method*>        shaders;
+  for (ClassType* pipelineClass : pipelineClasses_) {
+    for (ClassType* c = pipelineClass; c != nullptr; c = c->GetParent()) {
+      for (const auto& method : c->GetMethods()) {
         if ((method->modifiers & (Method::Modifier::Vertex | Method::Modifier::Fragment | Method::Modifier::Compute)) != 0) {
-          GenCodeForMethod(method.get());
+          if (seen.insert(method.get()).second) { shaders.push_back(method.get()); }
         }
       }
     }
   }
+  GenCodeForShaders(shaders);
+}
+
+void CodeGenLLVM::AddPipelineClass(Method* constructor) {
+  auto templ = constructor->classType->GetTemplate();
+  if (templ != NativeClass::RenderPipeline && templ != NativeClass::ComputePipeline) { return; }
+  Type* type = constructor->classType->GetTemplateArgs()[0];
+  if (!type->IsClass()) { return; }
+  auto pipelineClass = static_cast<ClassType*>(type);
+  if (std::find(pipelineClasses_.begin(), pipelineClasses_.end(), pipelineClass) ==
+      pipelineClasses_.end()) {
+    pipelineClasses_.push_back(pipelineClass);
+  }
 }
 
 llvm::Type* CodeGenLLVM::PadType(llvm::Type* type, int padding) {
@@ -204,7 +244,7 @@ llvm::Type* CodeGenLLVM::PadType(llvm::Type* type, int padding) {
 void CodeGenLLVM::ConvertAndAppendFieldTypes(ClassType*                classType,
                                              std::vector<llvm::Type*>* types) {
   if (classType->GetParent()) { ConvertAndAppendFieldTypes(classType->GetParent(), types); }
-  for (const auto& field : classType->GetFields()) {
+  for (Field* field : classType->GetFieldsInLayoutOrder()) {
     types->push_back(PadType(ConvertType(field->type), field->padding));
   }
   if (int padding = classType->GetPadding()) {
@@ -246,6 +286,9 @@ llvm::Type* CodeGenLLVM::ConvertType(Type* type) {
     return llvm::ArrayType::get(ConvertArrayElementType(atype), atype->GetNumElements());
   } else if (type->IsClass()) {
     ClassType*               classType = static_cast<ClassType*>(type);
+    if (classType->GetTemplate() == NativeClass::Atomic) {
+      return ConvertType(classType->GetTemplateArgs()[0]);
+    }
     if (auto placeholder = classPlaceholders_[classType]) {
       return placeholder;
     }
@@ -548,7 +591,7 @@ llvm::Intrinsic::ID CodeGenLLVM::FindIntrinsic(Method* method) {
 
 llvm::Value* CodeGenLLVM::GetSourceFile(const FileLocation& location) {
   const std::string* filename = location.filename.get();
-  Type*              type = types_->GetArrayType(types_->GetUByte(), 0, MemoryLayout::Default);
+  ArrayType*         type = types_->GetArrayType(types_->GetUByte(), 0, MemoryLayout::Default);
   return GenerateGlobalData(filename->c_str(), filename->length(), type);
 }
 
@@ -574,33 +617,56 @@ BuiltinCall CodeGenLLVM::FindBuiltin(Method* method) {
   return nullptr;
 }
 
+// Each shader entry point is generated into its own SPIR-V module (and for wasm, converted to
+// WGSL) independently of the others, so this work is spread over a pool of threads.  A task
+// writes only to its own Method; diagnostics are buffered and printed in entry point order so
+// that the output does not depend on scheduling.
+void CodeGenLLVM::GenCodeForShaders(const std::vector<Method*>& shaders) {
+  bool                     wasm = module_->getTargetTriple().isWasm();
+  std::vector<std::string> diagnostics(shaders.size());
+  ParallelFor(shaders.size(), shaderThreads_, [&](size_t i) {
+    std::ostringstream out;
+    GenCodeForShader(shaders[i], wasm, out);
+    diagnostics[i] = out.str();
+  });
+  for (const auto& d : diagnostics) { std::cerr << d; }
+}
+
+void CodeGenLLVM::GenCodeForShader(Method* method, bool wasm, std::ostream& diagnostics) {
+  CodeGenSPIRV codeGenSPIRV(types_);
+  codeGenSPIRV.Run(method);
+  std::vector<uint32_t> spirv;
+  spirv = codeGenSPIRV.header();
+  spirv.insert(spirv.end(), codeGenSPIRV.annotations().begin(), codeGenSPIRV.annotations().end());
+  spirv.insert(spirv.end(), codeGenSPIRV.decl().begin(), codeGenSPIRV.decl().end());
+  spirv.insert(spirv.end(), codeGenSPIRV.GetBody().begin(), codeGenSPIRV.GetBody().end());
+  if (!OptimizeSPIRV(spirvOptimization_, &spirv, diagnostics)) {
+    diagnostics << "SPIR-V optimization failed for " << method->classType->GetName() << "."
+                << method->name << "; using the unoptimized module\n";
+  }
+
+  if (wasm) {
+    tint::spirv::reader::Options spirvOptions;
+    tint::Program                program = tint::spirv::reader::Read(spirv, spirvOptions);
+    if (!program.IsValid()) {
+      diagnostics << "Tint SPIR-V reader failure:\n" << program.Diagnostics() << "\n";
+      return;
+    }
+    tint::wgsl::writer::Options wgslOptions;
+    auto                        result = tint::wgsl::writer::Generate(program, wgslOptions);
+    if (result != tint::Success) {
+      diagnostics << "Tint WGSL writer failure:\n" << result.Failure() << "\n";
+      return;
+    }
+    method->wgsl = result.Get().wgsl;
+  } else {
+    method->spirv = spirv;
+  }
+}
+
 void CodeGenLLVM::GenCodeForMethod(Method* method) {
   if ((method->modifiers & (Method::Modifier::Vertex | Method::Modifier::Fragment | Method::Modifier::Compute)) != 0) {
-    CodeGenSPIRV codeGenSPIRV(types_);
-    codeGenSPIRV.Run(method);
-    std::vector<uint32_t> spirv;
-    spirv = codeGenSPIRV.header();
-    spirv.insert(spirv.end(), codeGenSPIRV.annotations().begin(), codeGenSPIRV.annotations().end());
-    spirv.insert(spirv.end(), codeGenSPIRV.decl().begin(), codeGenSPIRV.decl().end());
-    spirv.insert(spirv.end(), codeGenSPIRV.GetBody().begin(), codeGenSPIRV.GetBody().end());
-
-    if (module_->getTargetTriple().isWasm()) {
-      tint::spirv::reader::Options spirvOptions;
-      tint::Program                program = tint::spirv::reader::Read(spirv, spirvOptions);
-      if (!program.IsValid()) {
-        std::cerr << "Tint SPIR-V reader failure:\n" << program.Diagnostics() << "\n";
-        return;
-      }
-      tint::wgsl::writer::Options wgslOptions;
-      auto                        result = tint::wgsl::writer::Generate(program, wgslOptions);
-      if (result != tint::Success) {
-        std::cerr << "Tint WGSL writer failure:\n" << result.Failure() << "\n";
-        return;
-      }
-      method->wgsl = result.Get().wgsl;
-    } else {
-      method->spirv = spirv;
-    }
+    GenCodeForShaders({method});
     return;
   }
   if (method->modifiers & Method::Modifier::DeviceOnly) { return; }
@@ -934,17 +1000,20 @@ Result CodeGenLLVM::Visit(CastExpr* expr) {
   return CreateCast(srcType, dstType, value, ConvertType(dstType));
 }
 
-llvm::Value* CodeGenLLVM::GenerateGlobalData(const void* data, size_t size, Type* type) {
+llvm::Value* CodeGenLLVM::GenerateGlobalData(const void* data, size_t size, ArrayType* type) {
   llvm::GlobalValue* var = dataVars_[data];
   if (!var) {
     llvm::StringRef stringRef(static_cast<const char*>(data), size);
     llvm::Constant* initializer = llvm::ConstantDataArray::getRaw(stringRef, size, byteType_);
-    var = new llvm::GlobalVariable(*module_, initializer->getType(), true,
-                                   llvm::GlobalVariable::InternalLinkage, initializer, "data");
-    dataVars_[data] = var;
+    auto* globalVar = new llvm::GlobalVariable(*module_, initializer->getType(), true,
+                                               llvm::GlobalVariable::InternalLinkage, initializer, "data");
+    // Typed data is accessed in place, so it must be aligned like its elements.
+    globalVar->setAlignment(llvm::Align(type->GetAlignmentInBytes()));
+    var = dataVars_[data] = globalVar;
   }
   llvm::Value* controlBlock = CreateControlBlock(type);
-  builder_->CreateStore(Int(size), GetArrayLengthAddress(controlBlock));
+  size_t length = type->IsUnsizedArray() ? size / type->GetElementSizeInBytes() : type->GetNumElements();
+  builder_->CreateStore(Int(length), GetArrayLengthAddress(controlBlock));
   llvm::Value* result = CreatePointer(var, controlBlock);
   // Add a ref so it can't actually be freed.
   RefStrongPtr(result);
@@ -953,8 +1022,23 @@ llvm::Value* CodeGenLLVM::GenerateGlobalData(const void* data, size_t size, Type
   return result;
 }
 
+llvm::GlobalVariable* CodeGenLLVM::FoldConstant(Expr* expr, int64_t size) {
+  std::vector<char> data(size, 0);
+  ConstantFolder constantFolder(types_, data.data());
+  constantFolder.Resolve(expr);
+  llvm::StringRef stringRef(data.data(), size);
+  llvm::Constant* initializer = llvm::ConstantDataArray::getRaw(stringRef, size, byteType_);
+  return new llvm::GlobalVariable(*module_, initializer->getType(), true,
+                                  llvm::GlobalVariable::InternalLinkage, initializer, "data");
+}
+
+Result CodeGenLLVM::Visit(PackedListExpr* expr) {
+  Type* type = expr->GetType(types_);
+  return builder_->CreateLoad(ConvertType(type), FoldConstant(expr, type->GetSizeInBytes()));
+}
+
 Result CodeGenLLVM::Visit(Data* expr) {
-  return GenerateGlobalData(expr->GetData(), expr->GetSize(), expr->GetType(types_));
+  return GenerateGlobalData(expr->GetData(), expr->GetSize(), expr->GetArrayType(types_));
 }
 
 Result CodeGenLLVM::Visit(Stmts* stmts) {
@@ -1135,6 +1219,9 @@ Result CodeGenLLVM::Visit(UIntConstant* node) {
   return llvm::ConstantInt::get(ConvertType(node->GetType(types_)), node->GetValue(), true);
 }
 
+// Overrides only vary per pipeline; on the host they always take their default value.
+Result CodeGenLLVM::Visit(SpecConstant* node) { return GenerateLLVM(node->GetDefaultValue()); }
+
 Result CodeGenLLVM::Visit(VarExpr* expr) { return allocas_[expr->GetVar()]; }
 
 Result CodeGenLLVM::Visit(TempVarExpr* node) {
@@ -1180,14 +1267,7 @@ Result CodeGenLLVM::Visit(StoreStmt* stmt) {
   // data segment and memcpy() from there.
   // FIXME: this should probably be done in a separate pass and produce a Data node.
   if (stmt->GetRHS()->IsConstant(types_) && size >= kMinAutoConstantSize) {
-    char* data = new char[size];
-    memset(data, 0, size);
-    ConstantFolder constantFolder(types_, data);
-    constantFolder.Resolve(stmt->GetRHS());
-    llvm::StringRef stringRef(static_cast<const char*>(data), size);
-    llvm::Constant* initializer = llvm::ConstantDataArray::getRaw(stringRef, size, byteType_);
-    auto rhs = new llvm::GlobalVariable(*module_, initializer->getType(), true,
-      llvm::GlobalVariable::InternalLinkage, initializer, "data");
+    auto rhs = FoldConstant(stmt->GetRHS(), size);
     builder_->CreateMemCpy(lhs, {}, rhs, {}, size);
   } else {
     llvm::Value* rhs = GenerateLLVM(stmt->GetRHS());
@@ -1331,7 +1411,7 @@ Result CodeGenLLVM::Visit(FieldAccess* node) {
     expr = allocaInst;
   }
   Field* field = node->GetField();
-  std::vector<llvm::Value*> indices = { Int(0), Int(field->index) };
+  std::vector<llvm::Value*> indices = { Int(0), Int(field->layoutIndex) };
   if (field->padding) indices.push_back(Int(0));
   auto result = builder_->CreateGEP(ConvertType(type), expr, indices);
   if (field->type->IsUnsizedArray()) { result = CreatePointer(result, length); }
@@ -1368,7 +1448,7 @@ Result CodeGenLLVM::Visit(Initializer* node) {
             auto wrapper = llvm::ConstantAggregateZero::get(type);
             v = builder_->CreateInsertValue(wrapper, v, 0);
           }
-          result = builder_->CreateInsertValue(result, v, field->index);
+          result = builder_->CreateInsertValue(result, v, field->layoutIndex);
         }
       }
     }
@@ -1439,10 +1519,56 @@ llvm::Value* CodeGenLLVM::GenerateInlineAPIMethod(Method* method, ExprList* argL
     } else if (method->name == "transpose") {
       return GenerateTranspose(GenerateLLVM(args[0]), static_cast<MatrixType*>(args[0]->GetType(types_)));
     }
+  } else if (method->classType->GetTemplate() == NativeClass::Atomic) {
+    return GenerateAtomic(method, args);
   }
   return nullptr;
 }
 
+llvm::Value* CodeGenLLVM::GenerateAtomic(Method* method, const std::vector<Expr*>& args) {
+  Type*        type = method->classType->GetTemplateArgs()[0];
+  llvm::Type*  llvmType = ConvertType(type);
+  llvm::Align  align(type->GetAlignmentInBytes());
+  auto         ordering = llvm::AtomicOrdering::SequentiallyConsistent;
+  llvm::Value* ptr = GenerateLLVM(args[0]);
+  if (method->name == "Load") {
+    llvm::LoadInst* load = builder_->CreateAlignedLoad(llvmType, ptr, align);
+    load->setAtomic(ordering);
+    return load;
+  } else if (method->name == "Store") {
+    llvm::StoreInst* store = builder_->CreateAlignedStore(GenerateLLVM(args[1]), ptr, align);
+    store->setAtomic(ordering);
+    return store;
+  } else if (method->name == "CompareExchange") {
+    llvm::Value* comparator = GenerateLLVM(args[1]);
+    llvm::Value* value = GenerateLLVM(args[2]);
+    llvm::Value* result =
+        builder_->CreateAtomicCmpXchg(ptr, comparator, value, align, ordering, ordering);
+    return builder_->CreateExtractValue(result, {0});
+  }
+  bool                       isSigned = !type->IsUnsigned();
+  llvm::AtomicRMWInst::BinOp op;
+  if (method->name == "Add") {
+    op = llvm::AtomicRMWInst::Add;
+  } else if (method->name == "Min") {
+    op = isSigned ? llvm::AtomicRMWInst::Min : llvm::AtomicRMWInst::UMin;
+  } else if (method->name == "Max") {
+    op = isSigned ? llvm::AtomicRMWInst::Max : llvm::AtomicRMWInst::UMax;
+  } else if (method->name == "And") {
+    op = llvm::AtomicRMWInst::And;
+  } else if (method->name == "Or") {
+    op = llvm::AtomicRMWInst::Or;
+  } else if (method->name == "Xor") {
+    op = llvm::AtomicRMWInst::Xor;
+  } else if (method->name == "Exchange") {
+    op = llvm::AtomicRMWInst::Xchg;
+  } else {
+    assert(!"unknown atomic method");
+    return nullptr;
+  }
+  return builder_->CreateAtomicRMW(op, ptr, GenerateLLVM(args[1]), align, ordering);
+}
+
 llvm::Value* CodeGenLLVM::GenerateMethodCall(Method*             method,
                                              ExprList*           argList,
                                              Type*               returnType,
@@ -1467,6 +1593,7 @@ llvm::Value* CodeGenLLVM::GenerateMethodCall(Method*             method,
     for (Type* const& type : method->classType->GetTemplateArgs()) {
       args.push_back(CreateTypePtr(type));
     }
+    AddPipelineClass(method);
   }
   llvm::Intrinsic::ID intrinsic = function->getIntrinsicID();
   for (auto arg : argList->Get()) {
@@ -20,6 +20,7 @@
 #include <llvm/IR/IRBuilder.h>
 
 #include <ast/ast.h>
+#include <codegen/spirv_optimizer.h>
 
 namespace llvm {
 class Value;
@@ -76,6 +77,8 @@ class CodeGenLLVM : public Visitor {
   llvm::Function* GetOrCreateMethodStub(Method* method);
   llvm::Value*    GetOrCreateDeleter(Type* type);
   void            GenCodeForMethod(Method* method);
+  void            GenCodeForShaders(const std::vector<Method*>& shaders);
+  void            GenCodeForShader(Method* method, bool wasm, std::ostream& diagnostics);
   llvm::Value*    GetStrongRefCountAddress(llvm::Value* controlBlock);
   llvm::Value*    GetWeakRefCountAddress(llvm::Value* controlBlock);
   llvm::Value*    GetArrayLengthAddress(llvm::Value* controlBlock);
@@ -133,9 +136,11 @@ class CodeGenLLVM : public Visitor {
   Result                Visit(LengthExpr* expr) override;
   Result                Visit(LoadExpr* expr) override;
   Result                Visit(NullConstant* node) override;
+  Result                Visit(PackedListExpr* expr) override;
   Result                Visit(ReturnStatement* stmt) override;
   Result                Visit(MethodCall* node) override;
   Result                Visit(SliceExpr* expr) override;
+  Result                Visit(SpecConstant* node) override;
   Result                Visit(Stmts* stmts) override;
   Result                Visit(SwizzleExpr* stmts) override;
   Result                Visit(TempVarExpr* expr) override;
@@ -151,6 +156,8 @@ class CodeGenLLVM : public Visitor {
   }
   void               ICE(ASTNode* node);
   void               SetDebugOutput(bool debugOutput) { debugOutput_ = debugOutput; }
+  void               SetSPIRVOptimization(SPIRVOptimization o) { spirvOptimization_ = o; }
+  void               SetShaderThreads(unsigned shaderThreads) { shaderThreads_ = shaderThreads; }
   llvm::GlobalValue* GetTypeList() const { return typeList_; }
   const std::vector<Type*>& GetReferencedTypes() { return referencedTypes_; }
 
@@ -161,16 +168,19 @@ class CodeGenLLVM : public Visitor {
                           llvm::Value* value,
                           llvm::Type*  dstLLVMType);
   llvm::Value* GenerateInlineAPIMethod(Method* method, ExprList* argList);
+  llvm::Value* GenerateAtomic(Method* method, const std::vector<Expr*>& args);
   llvm::Value* GenerateMethodCall(Method*             method,
                                   ExprList*           args,
                                   Type*               returnType,
                                   const FileLocation& location);
-  llvm::Value* GenerateGlobalData(const void* data, size_t size, Type* type);
+  llvm::Value* GenerateGlobalData(const void* data, size_t size, ArrayType* type);
+  llvm::GlobalVariable* FoldConstant(Expr* expr, int64_t size);
   llvm::BasicBlock* CreateBasicBlock(const char* name);
   void         AppendTemporary(llvm::Value* value, Type* type);
   void         DestroyTemporaries();
   void         Destroy(Type* type, llvm::Value* value);
   llvm::Value* CreateTypePtr(Type* type);
+  void         AddPipelineClass(Method* constructor);
   bool         NeedsAlignedMalloc() const;
 
  private:
@@ -191,6 +201,8 @@ class CodeGenLLVM : public Visitor {
   llvm::FunctionCallee                                  freeFunc_;
   llvm::Type*                                           controlBlockType_;
   bool                                                  debugOutput_;
+  SPIRVOptimization                                     spirvOptimization_ = SPIRVOptimization::None;
+  unsigned                                              shaderThreads_;
   DerefList                                             temporaries_;
   RefPtrTemporaries                                     scopedTemporaries_;
   llvm::Type*                                           typeListType_;
@@ -204,6 +216,7 @@ class CodeGenLLVM : public Visitor {
   std::vector<Type*>                                    referencedTypes_;
   std::unordered_map<Type*, llvm::Value*>               typeMap_;
   std::list<Method*>                                    pendingMethods_;
+  std::vector<ClassType*>                               pipelineClasses_;
 };
 
 };  // namespace Toucan
@@ -16,9 +16,12 @@
 
 #include <string.h>
 
+#include <bit>
+
 #include <spirv/1.2/GLSL.std.450.h>
 #include <spirv/unified1/spirv.hpp>
 
+#include <ast/constant_folder.h>
 #include <ast/native_class.h>
 #include <ast/shader_prep_pass.h>
 
@@ -58,6 +61,50 @@ bool isTextureView(ClassType* classType) {
          isSampleableTextureCube(classType);
 }
 
+// Storage textures are the plain Texture classes, as returned by CreateStorageView().
+bool isStorageTexture(ClassType* classType) {
+  auto templ = classType->GetTemplate();
+  return templ == NativeClass::Texture1D || templ == NativeClass::Texture2D ||
+         templ == NativeClass::Texture2DArray || templ == NativeClass::Texture3D;
+}
+
+struct StorageFormat {
+  const char*      name;
+  spv::ImageFormat format;
+};
+
+constexpr StorageFormat storageFormats[] = {
+  "RGBA8unorm",  spv::ImageFormatRgba8,
+  "RGBA8snorm",  spv::ImageFormatRgba8Snorm,
+  "RGBA8uint",   spv::ImageFormatRgba8ui,
+  "RGBA8sint",   spv::ImageFormatRgba8i,
+  "RGBA16uint",  spv::ImageFormatRgba16ui,
+  "RGBA16sint",  spv::ImageFormatRgba16i,
+  "RGBA16float", spv::ImageFormatRgba16f,
+  "R32uint",     spv::ImageFormatR32ui,
+  "R32sint",     spv::ImageFormatR32i,
+  "R32float",    spv::ImageFormatR32f,
+  "RG32uint",    spv::ImageFormatRg32ui,
+  "RG32sint",    spv::ImageFormatRg32i,
+  "RG32float",   spv::ImageFormatRg32f,
+  "RGBA32uint",  spv::ImageFormatRgba32ui,
+  "RGBA32sint",  spv::ImageFormatRgba32i,
+  "RGBA32float", spv::ImageFormatRgba32f,
+};
+
+spv::ImageFormat toImageFormat(ClassType* pixelFormat) {
+  for (const auto& f : storageFormats) {
+    if (pixelFormat->GetName() == f.name) { return f.format; }
+  }
+  return spv::ImageFormatUnknown;
+}
+
+bool isAtomic(ClassType* classType) { return classType->GetTemplate() == NativeClass::Atomic; }
+
+bool isSubgroup(ClassType* classType) {
+  return classType->GetNativeClass() == NativeClass::Subgroup;
+}
+
 bool isMath(ClassType* classType) { return classType->GetNativeClass() == NativeClass::Math; }
 
 bool isSystem(ClassType* classType) { return classType->GetNativeClass() == NativeClass::System; }
@@ -164,7 +211,7 @@ uint32_t CodeGenSPIRV::GetStorageClass(Type* type) {
   type = type->GetUnqualifiedType(&qualifiers);
   if (type->IsClass()) {
     auto classType = static_cast<ClassType*>(type);
-    if (isSampler(classType) || isTextureView(classType)) {
+    if (isSampler(classType) || isTextureView(classType) || isStorageTexture(classType)) {
       return spv::StorageClassUniformConstant;
     }
   }
@@ -172,6 +219,8 @@ uint32_t CodeGenSPIRV::GetStorageClass(Type* type) {
     return spv::StorageClassUniform;
   } else if (qualifiers & Type::Qualifier::Storage) {
     return spv::StorageClassStorageBuffer;
+  } else if (qualifiers & Type::Qualifier::Workgroup) {
+    return spv::StorageClassWorkgroup;
   }
   return spv::StorageClassFunction;
 }
@@ -229,6 +278,12 @@ void CodeGenSPIRV::DeclareBindGroupVars(const BindGroupList& bindGroups) {
       if (qualifiers & Type::Qualifier::Coherent) {
         Append(spv::OpDecorate, {varId, spv::DecorationCoherent}, &annotations_);
       }
+      if (qualifiers & Type::Qualifier::ReadOnly) {
+        Append(spv::OpDecorate, {varId, spv::DecorationNonWritable}, &annotations_);
+      }
+      if (qualifiers & Type::Qualifier::WriteOnly) {
+        Append(spv::OpDecorate, {varId, spv::DecorationNonReadable}, &annotations_);
+      }
       binding++;
     }
     group++;
@@ -240,6 +295,7 @@ void CodeGenSPIRV::Run(Method* entryPoint) {
   glslStd450Import_ = NextId();
   uint32_t functionId = NextId();
   methodModifiers_ = entryPoint->modifiers;
+  pipelineClass_ = entryPoint->classType;
   assert(entryPoint->formalArgList.size() > 0);
 
   NodeVector     nodes;
@@ -257,6 +313,20 @@ void CodeGenSPIRV::Run(Method* entryPoint) {
     pendingMethods_.pop_front();
     GenCodeForMethod(m, functions_[m]);
   }
+  interface.insert(interface.end(), builtInInterface_.begin(), builtInInterface_.end());
+
+  // A workgroup size that names an override is emitted as LocalSizeId, so that the pipeline
+  // can specialize it.  This must happen before the ID bound is written below.
+  Code workgroupSize;
+  if (methodModifiers_ & Method::Modifier::Compute) {
+    const auto& overrides = entryPoint->workgroupSizeOverrides;
+    if (overrides[0] || overrides[1] || overrides[2]) {
+      for (int i = 0; i < 3; ++i) {
+        workgroupSize.push_back(overrides[i] ? GenerateSPIRV(overrides[i])
+                                             : GetUIntConstant(entryPoint->workgroupSize[i]));
+      }
+    }
+  }
 
   header_.push_back(spv::MagicNumber);
   header_.push_back(0x00010300);
@@ -268,6 +338,9 @@ void CodeGenSPIRV::Run(Method* entryPoint) {
   Append(spv::OpCapability, {spv::CapabilityImageQuery}, &header_);
   Append(spv::OpCapability, {spv::CapabilitySampled1D}, &header_);
   Append(spv::OpCapability, {spv::CapabilityImage1D}, &header_);
+  for (uint32_t capability : capabilities_) {
+    Append(spv::OpCapability, {capability}, &header_);
+  }
   Code importName;
   AppendString("GLSL.std.450", &importName);
   header_.push_back(spv::OpExtInstImport | ((2 + importName.size()) << WordCountShift));
@@ -278,6 +351,11 @@ void CodeGenSPIRV::Run(Method* entryPoint) {
   AppendEntryPoint(executionModel, functionId, "main", interface);
   if (methodModifiers_ & Method::Modifier::Fragment) {
     Append(spv::OpExecutionMode, {functionId, spv::ExecutionModeOriginUpperLeft}, &header_);
+  } else if (!workgroupSize.empty()) {
+    Append(spv::OpExecutionModeId,
+           {functionId, spv::ExecutionModeLocalSizeId, workgroupSize[0], workgroupSize[1],
+            workgroupSize[2]},
+           &header_);
   } else if (methodModifiers_ & Method::Modifier::Compute) {
     auto ws = entryPoint->workgroupSize;
     Append(spv::OpExecutionMode, {functionId, spv::ExecutionModeLocalSize, ws[0], ws[1], ws[2]},
@@ -392,6 +470,10 @@ uint32_t CodeGenSPIRV::DeclareVar(Var* var) {
   assert(!var->type->IsPtr());
   uint32_t storageClass = GetStorageClass(var->type);
   uint32_t varType = ConvertPointerToType(var->type);
+  if (storageClass == spv::StorageClassWorkgroup) {
+    // Workgroup variables are shared by the whole workgroup, so they live at module scope.
+    return vars_[var] = AppendDecl(spv::Op::OpVariable, varType, {storageClass});
+  }
   return vars_[var] = AppendCode(spv::Op::OpVariable, varType, {storageClass});
 }
 
@@ -410,6 +492,26 @@ uint32_t CodeGenSPIRV::AppendImageDecl(uint32_t        dim,
                         {sampledType, dim, depth, arrayed, ms, sampled, format});
 }
 
+uint32_t CodeGenSPIRV::AppendStorageImageDecl(uint32_t dim, bool array, Type* pixelFormat) {
+  assert(pixelFormat->IsClass());
+  auto     formatClass = static_cast<ClassType*>(pixelFormat);
+  uint32_t sampledType = ConvertType(formatClass->FindType("DeviceType"));
+  uint32_t format = toImageFormat(formatClass);
+  if (format == spv::ImageFormatRg32ui || format == spv::ImageFormatRg32i ||
+      format == spv::ImageFormatRg32f) {
+    capabilities_.insert(spv::CapabilityStorageImageExtendedFormats);
+  } else if (format == spv::ImageFormatUnknown) {
+    capabilities_.insert(spv::CapabilityStorageImageReadWithoutFormat);
+    capabilities_.insert(spv::CapabilityStorageImageWriteWithoutFormat);
+  }
+  uint32_t depth = 0;    // not depth
+  uint32_t arrayed = array ? 1 : 0;
+  uint32_t ms = 0;       // not multisampled
+  uint32_t sampled = 2;  // read/write, without a sampler
+  return AppendTypeDecl(spv::Op::OpTypeImage,
+                        {sampledType, dim, depth, arrayed, ms, sampled, format});
+}
+
 uint32_t CodeGenSPIRV::ConvertType(Type* type) {
   int qualifiers;
   type = type->GetUnqualifiedType(&qualifiers);
@@ -435,7 +537,10 @@ uint32_t CodeGenSPIRV::ConvertType(Type* type) {
            &annotations_);
   } else if (type->IsClass()) {
     ClassType* classType = static_cast<ClassType*>(type);
-    if (isSampler(classType)) {
+    if (isAtomic(classType)) {
+      // Atomics are plain integers; only the instructions which access them differ.
+      return spirvTypes_[type] = ConvertType(classType->GetTemplateArgs()[0]);
+    } else if (isSampler(classType)) {
       resultId = AppendTypeDecl(spv::Op::OpTypeSampler, {});
     } else if (isSampleableTexture1D(classType)) {
       resultId = AppendImageDecl(spv::Dim1D, false, qualifiers, classType->GetTemplateArgs());
@@ -447,14 +552,28 @@ uint32_t CodeGenSPIRV::ConvertType(Type* type) {
       resultId = AppendImageDecl(spv::Dim2D, true, qualifiers, classType->GetTemplateArgs());
     } else if (isSampleableTextureCube(classType)) {
       resultId = AppendImageDecl(spv::DimCube, false, qualifiers, classType->GetTemplateArgs());
+    } else if (isStorageTexture(classType)) {
+      Type* pixelFormat = classType->GetTemplateArgs()[0];
+      switch (classType->GetTemplate()) {
+        case NativeClass::Texture1D:
+          resultId = AppendStorageImageDecl(spv::Dim1D, false, pixelFormat);
+          break;
+        case NativeClass::Texture2DArray:
+          resultId = AppendStorageImageDecl(spv::Dim2D, true, pixelFormat);
+          break;
+        case NativeClass::Texture3D:
+          resultId = AppendStorageImageDecl(spv::Dim3D, false, pixelFormat);
+          break;
+        default: resultId = AppendStorageImageDecl(spv::Dim2D, false, pixelFormat); break;
+      }
     } else {
       Code args;
-      for (auto& field : classType->GetFields()) {
+      for (Field* field : classType->GetFieldsInLayoutOrder()) {
         args.push_back(ConvertType(field->type));
       }
       resultId = AppendTypeDecl(spv::Op::OpTypeStruct, args);
       uint32_t i = 0;
-      for (auto& field : classType->GetFields()) {
+      for (Field* field : classType->GetFieldsInLayoutOrder()) {
         Append(spv::OpMemberDecorate,
                {resultId, i, spv::DecorationOffset, static_cast<uint32_t>(field->offset)},
                &annotations_);
@@ -544,7 +663,12 @@ uint32_t CodeGenSPIRV::ConvertPointerToType(Type* type) {
 }
 
 uint32_t CodeGenSPIRV::ConvertPointerToType(Type* type, uint32_t storageClass) {
-  PtrTypeKey key(type->GetUnqualifiedType(), storageClass);
+  Type* keyType = type->GetUnqualifiedType();
+  if (keyType->IsClass() && isAtomic(static_cast<ClassType*>(keyType))) {
+    // Share the pointer type with the underlying integer, since SPIR-V forbids duplicates.
+    keyType = static_cast<ClassType*>(keyType)->GetTemplateArgs()[0];
+  }
+  PtrTypeKey key(keyType, storageClass);
   if (spirvPtrTypes_[key] != 0) { return spirvPtrTypes_[key]; }
   uint32_t typeId = ConvertType(type);
   uint32_t resultId = AppendTypeDecl(spv::Op::OpTypePointer, {storageClass, typeId});
@@ -640,12 +764,44 @@ Result CodeGenSPIRV::Visit(Initializer* node) {
   auto     args = node->GetArgList()->Get();
   Code     resultArgs;
   uint32_t resultType = ConvertType(node->GetType());
-  for (auto arg : args) {
-    resultArgs.push_back(GenerateSPIRV(arg));
+  if (node->GetType()->IsClass()) {
+    // Class arguments are in declaration order; struct members are in layout order.
+    for (Field* field : static_cast<ClassType*>(node->GetType())->GetFieldsInLayoutOrder()) {
+      resultArgs.push_back(GenerateSPIRV(args[field->index]));
+    }
+  } else {
+    for (auto arg : args) {
+      resultArgs.push_back(GenerateSPIRV(arg));
+    }
   }
   return AppendCode(spv::Op::OpCompositeConstruct, resultType, {resultArgs});
 }
 
+uint32_t CodeGenSPIRV::GeneratePackedList(Type* type, PackedListExpr* node, size_t* index) {
+  type = type->GetUnqualifiedType();
+  if (type->IsArrayLike()) {
+    auto arrayLikeType = static_cast<ArrayLikeType*>(type);
+    Code elements;
+    for (uint32_t i = 0; i < arrayLikeType->GetNumElements(); ++i) {
+      elements.push_back(GeneratePackedList(arrayLikeType->GetElementType(), node, index));
+    }
+    return AppendCode(spv::Op::OpCompositeConstruct, ConvertType(type), {elements});
+  }
+  uint32_t value = node->GetValue((*index)++);
+  if (type->IsFloat()) {
+    return GetFloatConstant(std::bit_cast<float>(value));
+  } else if (type->IsUInt()) {
+    return GetUIntConstant(value);
+  } else {
+    return GetIntConstant(value);
+  }
+}
+
+Result CodeGenSPIRV::Visit(PackedListExpr* node) {
+  size_t index = 0;
+  return GeneratePackedList(node->GetType(types_), node, &index);
+}
+
 Result CodeGenSPIRV::Visit(ExprWithStmt* node) {
   auto resultId = node->GetExpr() ? GenerateSPIRV(node->GetExpr()) : 0u;
   GenerateSPIRV(node->GetStmt());
@@ -654,6 +810,31 @@ Result CodeGenSPIRV::Visit(ExprWithStmt* node) {
 
 Result CodeGenSPIRV::Visit(SmartToRawPtr* node) { return GenerateSPIRV(node->GetExpr()); }
 
+Result CodeGenSPIRV::Visit(SpecConstant* node) {
+  if (specConstants_[node]) { return specConstants_[node]; }
+  Type*    type = node->GetType(types_);
+  uint32_t resultType = ConvertType(type);
+  uint32_t value = 0;
+  ConstantFolder constantFolder(types_, &value);
+  constantFolder.Resolve(node->GetDefaultValue());
+  uint32_t resultId;
+  // SpecIds are numbered per class, so only the shader's own class (and its ancestors) own
+  // theirs in this module.  Another class's override can't be set through this pipeline, so it
+  // keeps its default value, as it does on the host.
+  if (!pipelineClass_ || pipelineClass_->FindOverride(node->GetID()) != node) {
+    resultId = type->IsBool() ? GetBoolConstant(value != 0) : GetConstant(type, value);
+    return specConstants_[node] = resultId;
+  }
+  if (type->IsBool()) {
+    uint32_t op = value ? spv::Op::OpSpecConstantTrue : spv::Op::OpSpecConstantFalse;
+    resultId = AppendDecl(op, resultType, {});
+  } else {
+    resultId = AppendDecl(spv::Op::OpSpecConstant, resultType, {value});
+  }
+  Append(spv::OpDecorate, {resultId, spv::DecorationSpecId, node->GetSpecId()}, &annotations_);
+  return specConstants_[node] = resultId;
+}
+
 Result CodeGenSPIRV::Visit(DestroyStmt* node) { return 0u; }
 
 Result CodeGenSPIRV::Visit(DoStatement* doStmt) {
@@ -725,7 +906,7 @@ Result CodeGenSPIRV::Visit(FieldAccess* expr) {
   Field*   field = expr->GetField();
 
   uint32_t resultType = ConvertType(expr->GetType(types_));
-  uint32_t index = GetIntConstant(field->index);
+  uint32_t index = GetIntConstant(field->layoutIndex);
   return AppendCode(spv::Op::OpAccessChain, resultType, {base, index});
 }
 
@@ -808,6 +989,129 @@ Result CodeGenSPIRV::Visit(ReturnStatement* stmt) {
   return 0u;
 }
 
+uint32_t CodeGenSPIRV::GenerateAtomic(Method* method, const std::vector<Expr*>& args) {
+  Type*    type = method->classType->GetTemplateArgs()[0];
+  uint32_t resultType = ConvertType(type);
+  uint32_t pointer = GenerateSPIRV(args[0]);
+  uint32_t storageClass = GetStorageClass(args[0]->GetType(types_));
+  uint32_t scope = GetIntConstant(storageClass == spv::StorageClassWorkgroup ? spv::ScopeWorkgroup
+                                                                             : spv::ScopeDevice);
+  uint32_t semantics = GetIntConstant(spv::MemorySemanticsMaskNone);
+  if (method->name == "Load") {
+    return AppendCode(spv::Op::OpAtomicLoad, resultType, {pointer, scope, semantics});
+  } else if (method->name == "Store") {
+    AppendCode(spv::Op::OpAtomicStore, {pointer, scope, semantics, GenerateSPIRV(args[1])});
+    return 0;
+  } else if (method->name == "CompareExchange") {
+    uint32_t comparator = GenerateSPIRV(args[1]);
+    uint32_t value = GenerateSPIRV(args[2]);
+    return AppendCode(spv::Op::OpAtomicCompareExchange, resultType,
+                      {pointer, scope, semantics, semantics, value, comparator});
+  }
+  bool     isSigned = !type->IsUnsigned();
+  uint32_t opCode;
+  if (method->name == "Add") {
+    opCode = spv::Op::OpAtomicIAdd;
+  } else if (method->name == "Min") {
+    opCode = isSigned ? spv::Op::OpAtomicSMin : spv::Op::OpAtomicUMin;
+  } else if (method->name == "Max") {
+    opCode = isSigned ? spv::Op::OpAtomicSMax : spv::Op::OpAtomicUMax;
+  } else if (method->name == "And") {
+    opCode = spv::Op::OpAtomicAnd;
+  } else if (method->name == "Or") {
+    opCode = spv::Op::OpAtomicOr;
+  } else if (method->name == "Xor") {
+    opCode = spv::Op::OpAtomicXor;
+  } else if (method->name == "Exchange") {
+    opCode = spv::Op::OpAtomicExchange;
+  } else {
+    assert(!"unknown atomic method");
+    return 0;
+  }
+  return AppendCode(opCode, resultType, {pointer, scope, semantics, GenerateSPIRV(args[1])});
+}
+
+// Subgroup built-ins are declared on first use, so that only shaders which use subgroups
+// require the GroupNonUniform capability.
+uint32_t CodeGenSPIRV::LoadBuiltIn(uint32_t builtIn, Type* type) {
+  uint32_t& varId = builtInVars_[builtIn];
+  if (varId == 0) {
+    uint32_t typeId = ConvertPointerToType(type, spv::StorageClassInput);
+    varId = AppendDecl(spv::Op::OpVariable, typeId, {spv::StorageClassInput});
+    Append(spv::OpDecorate, {varId, spv::DecorationBuiltIn, builtIn}, &annotations_);
+    builtInInterface_.push_back(varId);
+  }
+  return AppendCode(spv::Op::OpLoad, ConvertType(type), {varId});
+}
+
+uint32_t CodeGenSPIRV::GenerateSubgroupOp(Method* method, const std::vector<Expr*>& args) {
+  Type*    returnType = method->returnType;
+  uint32_t resultType = ConvertType(returnType);
+  capabilities_.insert(spv::CapabilityGroupNonUniform);
+  if (method->name == "InvocationId") {
+    return LoadBuiltIn(spv::BuiltInSubgroupLocalInvocationId, returnType);
+  } else if (method->name == "Size") {
+    return LoadBuiltIn(spv::BuiltInSubgroupSize, returnType);
+  }
+  uint32_t scope = GetIntConstant(spv::ScopeSubgroup);
+  uint32_t value = GenerateSPIRV(args[0]);
+  if (method->name == "Ballot") {
+    capabilities_.insert(spv::CapabilityGroupNonUniformBallot);
+    return AppendCode(spv::Op::OpGroupNonUniformBallot, resultType, {scope, value});
+  } else if (method->name == "Broadcast") {
+    capabilities_.insert(spv::CapabilityGroupNonUniformBallot);
+    uint32_t id = GenerateSPIRV(args[1]);
+    return AppendCode(spv::Op::OpGroupNonUniformBroadcast, resultType, {scope, value, id});
+  } else if (method->name == "Shuffle") {
+    capabilities_.insert(spv::CapabilityGroupNonUniformShuffle);
+    uint32_t id = GenerateSPIRV(args[1]);
+    return AppendCode(spv::Op::OpGroupNonUniformShuffle, resultType, {scope, value, id});
+  }
+  uint32_t groupOperation;
+  if (method->name == "Add") {
+    groupOperation = spv::GroupOperationReduce;
+  } else if (method->name == "InclusiveAdd") {
+    groupOperation = spv::GroupOperationInclusiveScan;
+  } else if (method->name == "ExclusiveAdd") {
+    groupOperation = spv::GroupOperationExclusiveScan;
+  } else {
+    assert(!"unknown subgroup method");
+    return 0;
+  }
+  capabilities_.insert(spv::CapabilityGroupNonUniformArithmetic);
+  uint32_t opCode =
+      returnType->IsFloat() ? spv::Op::OpGroupNonUniformFAdd : spv::Op::OpGroupNonUniformIAdd;
+  return AppendCode(opCode, resultType, {scope, groupOperation, value});
+}
+
+// Load() and Store() on a storage texture view.  2D array views take the layer as a separate
+// argument, which is appended to the coordinate.
+uint32_t CodeGenSPIRV::GenerateStorageTextureOp(Method* method, const std::vector<Expr*>& args) {
+  Type*    textureType = static_cast<PtrType*>(args[0]->GetType(types_))->GetBaseType();
+  uint32_t texture = GenerateSPIRV(args[0]);
+  texture = AppendCode(spv::Op::OpLoad, ConvertType(textureType), {texture});
+  uint32_t coord = GenerateSPIRV(args[1]);
+  size_t   nextArg = 2;
+  if (method->classType->GetTemplate() == NativeClass::Texture2DArray) {
+    uint32_t layer = GenerateSPIRV(args[nextArg++]);
+    uint32_t uint3 = ConvertType(types_->GetVector(types_->GetUInt(), 3));
+    uint32_t uintType = ConvertType(types_->GetUInt());
+    uint32_t x = AppendCode(spv::Op::OpCompositeExtract, uintType, {coord, 0});
+    uint32_t y = AppendCode(spv::Op::OpCompositeExtract, uintType, {coord, 1});
+    coord = AppendCode(spv::Op::OpCompositeConstruct, uint3, {x, y, layer});
+  }
+  if (method->name == "Load") {
+    uint32_t resultType = ConvertType(method->returnType);
+    return AppendCode(spv::Op::OpImageRead, resultType, {texture, coord});
+  } else if (method->name == "Store") {
+    uint32_t texel = GenerateSPIRV(args[nextArg]);
+    AppendCode(spv::Op::OpImageWrite, {texture, coord, texel});
+    return 0u;
+  }
+  assert(false);
+  return 0u;
+}
+
 Result CodeGenSPIRV::Visit(MethodCall* expr) {
   Method*                   method = expr->GetMethod();
   const std::vector<Expr*>& args = expr->GetArgList()->Get();
@@ -860,6 +1164,12 @@ Result CodeGenSPIRV::Visit(MethodCall* expr) {
       texture = AppendCode(spv::Op::OpLoad, ConvertType(textureType), {texture});
       return AppendCode(spv::Op::OpImageQuerySizeLod, resultType, {texture, GetIntConstant(0)});
     }
+  } else if (isStorageTexture(method->classType)) {
+    return GenerateStorageTextureOp(method, args);
+  } else if (isAtomic(method->classType)) {
+    return GenerateAtomic(method, args);
+  } else if (isSubgroup(method->classType)) {
+    return GenerateSubgroupOp(method, args);
   } else if (isMath(method->classType)) {
     uint32_t resultType = ConvertType(expr->GetType(types_));
     ExprList* argList = expr->GetArgList();
@@ -887,10 +1197,17 @@ Result CodeGenSPIRV::Visit(MethodCall* expr) {
       return AppendExtInst(GLSLstd450Ceil, resultType, argList);
     } else if (method->name == "length") {
       return AppendExtInst(GLSLstd450Length, resultType, argList);
-    } else if (method->name == "min") {
-      return AppendExtInst(GLSLstd450FMin, resultType, argList);
-    } else if (method->name == "max") {
-      return AppendExtInst(GLSLstd450FMax, resultType, argList);
+    } else if (method->name == "min" || method->name == "max") {
+      Type* type = expr->GetType(types_);
+      if (type->IsVector()) { type = static_cast<VectorType*>(type)->GetElementType(); }
+      bool isMin = method->name == "min";
+      if (type->IsFloatingPoint()) {
+        return AppendExtInst(isMin ? GLSLstd450FMin : GLSLstd450FMax, resultType, argList);
+      } else if (type->IsUnsigned()) {
+        return AppendExtInst(isMin ? GLSLstd450UMin : GLSLstd450UMax, resultType, argList);
+      } else {
+        return AppendExtInst(isMin ? GLSLstd450SMin : GLSLstd450SMax, resultType, argList);
+      }
     } else if (method->name == "pow") {
       return AppendExtInst(GLSLstd450Pow, resultType, argList);
     } else if (method->name == "reflect") {
@@ -912,7 +1229,15 @@ Result CodeGenSPIRV::Visit(MethodCall* expr) {
       resultArgs.push_back(GetIntConstant(spv::MemorySemanticsUniformMemoryMask |
                                           spv::MemorySemanticsAcquireReleaseMask));
       AppendCode(spv::Op::OpControlBarrier, resultArgs);
-      return {};  // FIXME: handle void method returns
+      return 0u;  // FIXME: handle void method returns
+    } else if (method->name == "WorkgroupBarrier") {
+      Code resultArgs;
+      resultArgs.push_back(GetIntConstant(spv::ScopeWorkgroup));
+      resultArgs.push_back(GetIntConstant(spv::ScopeWorkgroup));
+      resultArgs.push_back(GetIntConstant(spv::MemorySemanticsWorkgroupMemoryMask |
+                                          spv::MemorySemanticsAcquireReleaseMask));
+      AppendCode(spv::Op::OpControlBarrier, resultArgs);
+      return 0u;  // FIXME: handle void method returns
     } else if (method->name == "GetSourceLine") {
       return GetUIntConstant(expr->GetFileLocation().lineNum);
     }
@@ -16,6 +16,7 @@
 #define _CODEGEN_CODEGEN_SPIRV_H_
 
 #include <list>
+#include <set>
 #include <unordered_map>
 
 #include <ast/ast.h>
@@ -57,8 +58,11 @@ class CodeGenSPIRV : public Visitor {
   uint32_t AppendCodeFromExprList(uint32_t opCode, uint32_t resultType, ExprList* exprList);
   uint32_t AppendDecl(uint32_t opCode, uint32_t resultType, const Code& args);
   uint32_t AppendExtInst(uint32_t extInst, uint32_t resultType, ExprList* argList);
+  uint32_t GenerateAtomic(Method* method, const std::vector<Expr*>& args);
+  uint32_t GenerateSubgroupOp(Method* method, const std::vector<Expr*>& args);
   uint32_t GetStorageClass(Type* type);
   uint32_t AppendImageDecl(uint32_t dim, bool array, int qualifiers, const TypeList& templateArgs);
+  uint32_t AppendStorageImageDecl(uint32_t dim, bool array, Type* pixelFormat);
   uint32_t ConvertType(Type* type);
   uint32_t GetFunctionType(const Code& signature);
   uint32_t ConvertPointerToType(Type* type, uint32_t storageClass);
@@ -69,11 +73,13 @@ class CodeGenSPIRV : public Visitor {
   uint32_t GetFloatConstant(float value);
   uint32_t GetBoolConstant(bool value);
   uint32_t GetZeroConstant(Type* type);
+  uint32_t GeneratePackedList(Type* type, PackedListExpr* node, size_t* index);
   Result   Visit(ArrayAccess* node) override;
   Result   Visit(BinOpNode* node) override;
   Result   Visit(BoolConstant* expr) override;
   Result   Visit(CastExpr* expr) override;
   Result   Visit(SmartToRawPtr* node) override;
+  Result   Visit(SpecConstant* node) override;
   Result   Visit(DestroyStmt* stmt) override;
   Result   Visit(DoStatement* stmt) override;
   Result   Visit(ExprStmt* exprStmt) override;
@@ -84,6 +90,7 @@ class CodeGenSPIRV : public Visitor {
   Result   Visit(IfStatement* stmt) override;
   Result   Visit(Initializer* node) override;
   Result   Visit(IntConstant* intConstant) override;
+  Result   Visit(PackedListExpr* node) override;
   Result   Visit(ReturnStatement* stmt) override;
   Result   Visit(MethodCall* node) override;
   Result   Visit(Stmts* stmts) override;
@@ -116,6 +123,8 @@ class CodeGenSPIRV : public Visitor {
   uint32_t CreateVectorSplat(uint32_t value, VectorType* type);
   uint32_t CreateCast(Type* srcType, Type* dstType, uint32_t resultType, uint32_t valueId);
   uint32_t GetSampledImageType(Type* imageType);
+  uint32_t GenerateStorageTextureOp(Method* method, const std::vector<Expr*>& args);
+  uint32_t LoadBuiltIn(uint32_t builtIn, Type* type);
 
   uint32_t                                     nextID_ = 1;
   uint32_t                                     glslStd450Import_;
@@ -133,11 +142,16 @@ class CodeGenSPIRV : public Visitor {
   std::unordered_map<uint32_t, uint32_t>       uintConstants_;
   std::unordered_map<float, uint32_t>          floatConstants_;
   uint32_t                                     boolConstants_[2] = { 0u, 0u };
+  std::unordered_map<SpecConstant*, uint32_t>  specConstants_;
   std::unordered_map<Method*, uint32_t>        functions_;
   std::unordered_map<Var*, uint32_t>           vars_;
   std::list<Method*>                           pendingMethods_;
   BindGroupList                                bindGroups_;
   int                                          methodModifiers_;
+  ClassType*                                   pipelineClass_ = nullptr;  // owns the SpecIds
+  std::set<uint32_t>                           capabilities_;
+  std::unordered_map<uint32_t, uint32_t>       builtInVars_;
+  Code                                         builtInInterface_;
 };
 
 };  // namespace Toucan
@@ -0,0 +1,84 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "spirv_optimizer.h"
+
+#include <string.h>
+
+#include <spirv-tools/libspirv.hpp>
+#include <spirv-tools/optimizer.hpp>
+
+namespace Toucan {
+
+namespace {
+
+// CodeGenSPIRV emits SPIR-V 1.3.  The universal environment checks the module itself without
+// the extra Vulkan client rules, which Tint does not rely on either.
+const spv_target_env kTargetEnv = SPV_ENV_UNIVERSAL_1_3;
+
+// Returns a consumer which writes warnings and errors to "out".  Each shader is optimized on
+// its own thread with its own stream, so nothing here is shared.
+spvtools::MessageConsumer PrintTo(std::ostream& out) {
+  return [&out](spv_message_level_t level, const char*, const spv_position_t& position,
+                const char* message) {
+    if (level > SPV_MSG_WARNING) { return; }
+    out << "SPIR-V " << (level == SPV_MSG_WARNING ? "warning" : "error") << " at word "
+        << position.index << ": " << message << "\n";
+  };
+}
+
+}  // namespace
+
+bool ParseSPIRVOptimization(const char* str, SPIRVOptimization* result) {
+  if (!strcmp(str, "none")) {
+    *result = SPIRVOptimization::None;
+  } else if (!strcmp(str, "validate")) {
+    *result = SPIRVOptimization::Validate;
+  } else if (!strcmp(str, "performance")) {
+    *result = SPIRVOptimization::Performance;
+  } else if (!strcmp(str, "size")) {
+    *result = SPIRVOptimization::Size;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool OptimizeSPIRV(SPIRVOptimization      optimization,
+                   std::vector<uint32_t>* spirv,
+                   std::ostream&          diagnostics) {
+  if (optimization == SPIRVOptimization::None) { return true; }
+
+  spvtools::SpirvTools tools(kTargetEnv);
+  tools.SetMessageConsumer(PrintTo(diagnostics));
+  if (!tools.Validate(*spirv)) { return false; }
+  if (optimization == SPIRVOptimization::Validate) { return true; }
+
+  spvtools::Optimizer optimizer(kTargetEnv);
+  optimizer.SetMessageConsumer(PrintTo(diagnostics));
+  if (optimization == SPIRVOptimization::Performance) {
+    optimizer.RegisterPerformancePasses();
+  } else {
+    optimizer.RegisterSizePasses();
+  }
+  // The input was validated above; the passes themselves are trusted to preserve validity.
+  spvtools::OptimizerOptions options;
+  options.set_run_validator(false);
+  std::vector<uint32_t> optimized;
+  if (!optimizer.Run(spirv->data(), spirv->size(), &optimized, options)) { return false; }
+  *spirv = std::move(optimized);
+  return true;
+}
+
+};  // namespace Toucan
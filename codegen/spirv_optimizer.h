@@ -0,0 +1,41 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _CODEGEN_SPIRV_OPTIMIZER_H_
+#define _CODEGEN_SPIRV_OPTIMIZER_H_
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace Toucan {
+
+enum class SPIRVOptimization {
+  None,         // store the generated code as is
+  Validate,     // validate only
+  Performance,  // validate, then run the SPIRV-Tools performance recipe
+  Size,         // validate, then run the SPIRV-Tools size recipe
+};
+
+// Parses "none", "validate", "performance" or "size".  Returns false for anything else.
+bool ParseSPIRVOptimization(const char* str, SPIRVOptimization* result);
+
+// Validates and optimizes a generated shader module in place.  Diagnostics are written to
+// "diagnostics"; on failure the module is left unchanged and false is returned.
+bool OptimizeSPIRV(SPIRVOptimization      optimization,
+                   std::vector<uint32_t>* spirv,
+                   std::ostream&          diagnostics);
+
+};  // namespace Toucan
+#endif
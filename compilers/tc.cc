@@ -17,6 +17,7 @@
 #else
 #include <unistd.h>
 #endif
+#include <stdlib.h>
 
 #include <fstream>
 #include <iostream>
@@ -44,6 +45,7 @@
 #include <bindings/gen_bindings.h>
 #include <codegen/codegen_llvm.h>
 #include <codegen/codegen_spirv.h>
+#include <codegen/spirv_optimizer.h>
 #include <parser/parser.h>
 
 using namespace Toucan;
@@ -71,9 +73,13 @@ ClassType* FindClass(TypeTable* types, std::string name) {
 int main(int argc, char** argv) {
   bool dump = false;
   bool spirv = false;
+  SPIRVOptimization spirvOptimization = SPIRVOptimization::None;
+  int  shaderThreads = 0;
+  bool reorderFields = false;
+  bool fieldReport = false;
 
   int                      opt;
-  char                     optstring[] = "dsvc:m:o:i:I:t:f:";
+  char                     optstring[] = "dsvc:m:o:i:I:t:f:O:j:lL";
   std::string              classname = "Class";
   std::string              methodname = "method";
   std::string              outputFilename = "a.o";
@@ -95,6 +101,15 @@ std::string targetTripleStr;
       case 'I': includePaths.push_back(optarg); break;
       case 't': targetTripleStr = optarg; break;
       case 'f': features = optarg; break;
+      case 'O':
+        if (!ParseSPIRVOptimization(optarg, &spirvOptimization)) {
+          std::cerr << "Unknown SPIR-V optimization \"" << optarg << "\"" << std::endl;
+          exit(1);
+        }
+        break;
+      case 'j': shaderThreads = atoi(optarg); break;
+      case 'l': reorderFields = true; break;
+      case 'L': reorderFields = fieldReport = true; break;
     }
   }
 
@@ -118,7 +133,8 @@ std::string targetTripleStr;
   SemanticPass semanticPass(&nodes, &types);
   rootStmts = semanticPass.Run(rootStmts);
   if (semanticPass.GetNumErrors() > 0) { exit(2); }
-  types.ComputeFieldOffsets();
+  types.ComputeFieldOffsets(reorderFields);
+  if (fieldReport) { types.PrintFieldReorderingReport(stderr); }
   if (spirv) {
     ClassType* c = FindClass(&types, classname);
     if (!c) {
@@ -136,10 +152,13 @@ std::string targetTripleStr;
     std::vector<uint32_t> output;
     CodeGenSPIRV          codeGenSPIRV(&types);
     codeGenSPIRV.Run(m);
-    WriteCode(codeGenSPIRV.header());
-    WriteCode(codeGenSPIRV.annotations());
-    WriteCode(codeGenSPIRV.decl());
-    WriteCode(codeGenSPIRV.GetBody());
+    output = codeGenSPIRV.header();
+    output.insert(output.end(), codeGenSPIRV.annotations().begin(),
+                  codeGenSPIRV.annotations().end());
+    output.insert(output.end(), codeGenSPIRV.decl().begin(), codeGenSPIRV.decl().end());
+    output.insert(output.end(), codeGenSPIRV.GetBody().begin(), codeGenSPIRV.GetBody().end());
+    OptimizeSPIRV(spirvOptimization, &output, std::cerr);
+    WriteCode(output);
   } else {
     LLVMInitializeAllTargetInfos();
     LLVMInitializeAllTargets();
@@ -182,6 +201,8 @@ std::string targetTripleStr;
     fpm.add(llvm::createCFGSimplificationPass());
     CodeGenLLVM codeGenLLVM(&context, &types, module.get(), &builder, &fpm);
     codeGenLLVM.SetDebugOutput(dump);
+    codeGenLLVM.SetSPIRVOptimization(spirvOptimization);
+    if (shaderThreads > 0) { codeGenLLVM.SetShaderThreads(shaderThreads); }
     std::string errStr;
     codeGenLLVM.Run(rootStmts);
     if (verifyFunction(*main)) { printf("LLVM main function is broken; aborting\n"); }
@@ -17,6 +17,7 @@
 #else
 #include <unistd.h>
 #endif
+#include <stdlib.h>
 
 #include <iostream>
 
@@ -40,6 +41,7 @@
 #include <ast/type.h>
 #include <codegen/codegen_llvm.h>
 #include <codegen/codegen_spirv.h>
+#include <codegen/spirv_optimizer.h>
 #include <parser/parser.h>
 
 using namespace Toucan;
@@ -89,10 +91,14 @@ ClassType* FindClass(TypeTable* types, std::string name) {
 int main(int argc, char** argv) {
   bool dump = false;
   bool spirv = false;
+  SPIRVOptimization spirvOptimization = SPIRVOptimization::None;
+  int  shaderThreads = 0;
+  bool reorderFields = false;
+  bool fieldReport = false;
   bool showTime = false;
 
   int                      opt;
-  char                     optstring[] = "dsvtc:m:I:";
+  char                     optstring[] = "dsvtc:m:I:O:j:lL";
   std::string              classname = "Class";
   std::string              methodname = "method";
   std::vector<std::string> includePaths;
@@ -106,6 +112,15 @@ int main(int argc, char** argv) {
       case 'c': classname = optarg; break;
       case 'm': methodname = optarg; break;
       case 'I': includePaths.push_back(optarg); break;
+      case 'O':
+        if (!ParseSPIRVOptimization(optarg, &spirvOptimization)) {
+          std::cerr << "Unknown SPIR-V optimization \"" << optarg << "\"" << std::endl;
+          exit(1);
+        }
+        break;
+      case 'j': shaderThreads = atoi(optarg); break;
+      case 'l': reorderFields = true; break;
+      case 'L': reorderFields = fieldReport = true; break;
     }
   }
 
@@ -125,7 +140,8 @@ int main(int argc, char** argv) {
   SemanticPass semanticPass(&nodes, &types);
   rootStmts = semanticPass.Run(rootStmts);
   if (semanticPass.GetNumErrors() > 0) { exit(2); }
-  types.ComputeFieldOffsets();
+  types.ComputeFieldOffsets(reorderFields);
+  if (fieldReport) { types.PrintFieldReorderingReport(stderr); }
   double start, end;
   if (spirv) {
     ClassType* c = FindClass(&types, classname);
@@ -144,10 +160,13 @@ int main(int argc, char** argv) {
     std::vector<uint32_t> output;
     CodeGenSPIRV          codeGenSPIRV(&types);
     codeGenSPIRV.Run(m);
-    WriteCode(codeGenSPIRV.header());
-    WriteCode(codeGenSPIRV.annotations());
-    WriteCode(codeGenSPIRV.decl());
-    WriteCode(codeGenSPIRV.GetBody());
+    output = codeGenSPIRV.header();
+    output.insert(output.end(), codeGenSPIRV.annotations().begin(),
+                  codeGenSPIRV.annotations().end());
+    output.insert(output.end(), codeGenSPIRV.decl().begin(), codeGenSPIRV.decl().end());
+    output.insert(output.end(), codeGenSPIRV.GetBody().begin(), codeGenSPIRV.GetBody().end());
+    OptimizeSPIRV(spirvOptimization, &output, std::cerr);
+    WriteCode(output);
     exit(0);
   }
 
@@ -169,6 +188,8 @@ int main(int argc, char** argv) {
   fpm.add(llvm::createCFGSimplificationPass());
   CodeGenLLVM codeGenLLVM(&context, &types, module.get(), &builder, &fpm);
   codeGenLLVM.SetDebugOutput(dump);
+  codeGenLLVM.SetSPIRVOptimization(spirvOptimization);
+  if (shaderThreads > 0) { codeGenLLVM.SetShaderThreads(shaderThreads); }
   std::string            errStr;
   llvm::ExecutionEngine* engine = llvm::EngineBuilder(std::move(module))
                                       .setEngineKind(llvm::EngineKind::JIT)
@@ -37,5 +37,8 @@ class ASTTypeList;
 class ASTFormalTemplateArgList;
 class UnresolvedInitializer;
 };  // namespace Toucan
+extern Toucan::Expr* MakePackedList(std::vector<uint32_t>&& values,
+                                    std::vector<uint32_t>&& shape,
+                                    bool                    isFloat);
 #endif
 #define register
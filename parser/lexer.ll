@@ -14,12 +14,16 @@
  */
 
 %{
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
+#include <bit>
+#include <charconv>
 #include <optional>
 #include <unordered_map>
 #include <stack>
 #include <string>
+#include <vector>
 
 #include "parser/lexer.h"
 #include "ast/type.h"
@@ -34,6 +38,19 @@ std::unordered_map<std::string, std::string> identifiers_;
 
 #define YY_NEVER_INTERACTIVE 1
 
+// After a failed packed list, the characters it spanned are lexed in the UNPACKED
+// start condition, where the packed-list rule can't match again at each nested
+// "{". Otherwise a long malformed list would be rescanned once per brace.
+size_t unpackedChars = 0;
+#define YY_USER_ACTION                                  \
+  if (YY_START == UNPACKED) {                           \
+    if (static_cast<size_t>(yyleng) >= unpackedChars) { \
+      BEGIN(INITIAL);                                   \
+    } else {                                            \
+      unpackedChars -= yyleng;                          \
+    }                                                   \
+  }
+
 // This should fix the unistd.h problem on Windows, except that YY_NO_UNISTD_H
 // is only valid in flex 2.5.6 and up.  :(
 #ifdef _WIN32
@@ -52,6 +69,115 @@ long readUInt(const char* text, int base) {
   return val;
 }
 
+// Lists with fewer literals than this go through the regular token stream.
+constexpr size_t kMinPackedListSize = 256;
+
+// Returns the end of the int ([0-9]+) or float ({FLOAT}) literal starting at
+// "p", or nullptr if there is none. This must accept exactly what the rules
+// below accept, so that packing a list never changes how its literals lex.
+const char* scanNumber(const char* p, const char* end, bool* isFloat) {
+  const char* digits = p;
+  while (p < end && isdigit(*p)) p++;
+  bool hasDigits = p != digits;
+  *isFloat = false;
+  if (p < end && *p == '.') {
+    const char* fraction = ++p;
+    while (p < end && isdigit(*p)) p++;
+    if (p == fraction) return nullptr;
+    *isFloat = true;
+  } else if (!hasDigits) {
+    return nullptr;
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    p++;
+    if (p < end && (*p == '+' || *p == '-')) p++;
+    const char* exponent = p;
+    while (p < end && isdigit(*p)) p++;
+    if (p == exponent) return nullptr;
+    *isFloat = true;
+  }
+  return p;
+}
+
+// Scans a literal of the form {{1, 2, 3}, {4, 5, 6}, ...}, where every sublist
+// at a given depth has the same length and every element is a plain int (or
+// every element a plain float) literal, optionally negated. Returns the number
+// of characters consumed, or 0 if the text is anything else, in which case it
+// is lexed token by token as usual.
+size_t scanPackedList(const char*            text,
+                      size_t                 length,
+                      std::vector<uint32_t>* values,
+                      std::vector<uint32_t>* shape,
+                      bool*                  isFloat) {
+  const char*           p = text;
+  const char*           end = text + length;
+  std::vector<uint32_t> counts;
+  bool                  expectElement = false;
+  size_t                leafDepth = 0;
+  do {
+    while (p < end && isspace(*p)) p++;
+    if (p == end) return 0;
+    if (*p == '{') {
+      if (!counts.empty() && !expectElement) return 0;
+      if (leafDepth != 0 && counts.size() >= leafDepth) return 0;
+      counts.push_back(0);
+      expectElement = true;
+      p++;
+    } else if (*p == '}') {
+      if (expectElement) return 0;
+      size_t depth = counts.size() - 1;
+      if (shape->size() <= depth) shape->resize(depth + 1, 0);
+      if ((*shape)[depth] == 0) {
+        (*shape)[depth] = counts[depth];
+      } else if ((*shape)[depth] != counts[depth]) {
+        return 0;
+      }
+      counts.pop_back();
+      if (!counts.empty()) counts.back()++;
+      p++;
+    } else if (*p == ',') {
+      if (expectElement) return 0;
+      expectElement = true;
+      p++;
+    } else {
+      if (!expectElement) return 0;
+      if (leafDepth == 0) {
+        leafDepth = counts.size();
+      } else if (leafDepth != counts.size()) {
+        return 0;
+      }
+      const char* start = p;
+      bool        negative = *p == '-';
+      if (negative) p++;
+      const char* digits = p;
+      bool        floatLiteral;
+      p = scanNumber(digits, end, &floatLiteral);
+      if (!p) return 0;
+      if (p < end && !isspace(*p) && *p != ',' && *p != '}') return 0;
+      if (values->empty()) {
+        *isFloat = floatLiteral;
+      } else if (*isFloat != floatLiteral) {
+        return 0;
+      }
+      if (floatLiteral) {
+        float value;
+        auto  result = std::from_chars(start, p, value);
+        if (result.ec != std::errc() || result.ptr != p) return 0;
+        values->push_back(std::bit_cast<uint32_t>(value));
+      } else {
+        uint32_t value;
+        auto     result = std::from_chars(digits, p, value);
+        if (result.ec != std::errc() || result.ptr != p) return 0;
+        values->push_back(negative ? 0u - value : value);
+      }
+      counts.back()++;
+      expectElement = false;
+    }
+  } while (!counts.empty());
+  if (values->size() < kMinPackedListSize) return 0;
+  return p - text;
+}
+
 }
 
 %}
@@ -59,16 +185,34 @@ long readUInt(const char* text, int base) {
 ALPHA           [a-zA-Z_]
 ALPHANUM        [a-zA-Z0-9_]
 EXPONENT        ([Ee]("-"|"+")?[0-9]+)
+FLOAT           (([0-9]+"."[0-9]+|[0-9]*"."[0-9]+){EXPONENT}?|[0-9]+{EXPONENT})
+PACKEDCHAR      [-+.0-9eE \t\r\n,{}]
 
-%%
+%s UNPACKED
 
-([0-9]+"."[0-9]+|[0-9]*"."[0-9]+){EXPONENT}? { yylval.f = std::strtof(yytext, nullptr); return T_FLOAT_LITERAL; }
+%%
 
-([0-9]+"."[0-9]+|[0-9]*"."[0-9]+){EXPONENT}?d { yylval.d = std::strtod(yytext, nullptr); return T_DOUBLE_LITERAL; }
+<INITIAL>"{"[ \t\r\n{]*[-.0-9]{PACKEDCHAR}*"}" {
+  std::vector<uint32_t> values, shape;
+  bool                  isFloat = false;
+  size_t                length = scanPackedList(yytext, yyleng, &values, &shape, &isFloat);
+  if (length == 0) {
+    unpackedChars = yyleng - 1;
+    BEGIN(UNPACKED);
+    yyless(1);
+    return '{';
+  }
+  yyless(length);
+  yylval.expr = MakePackedList(std::move(values), std::move(shape), isFloat);
+  for (const char* s = yytext; *s; s++) {
+    if (*s == '\n') IncLineNum();
+  }
+  return T_PACKED_LIST_LITERAL;
+}
 
-[0-9]+{EXPONENT}      { yylval.f = std::strtof(yytext, nullptr); return T_FLOAT_LITERAL; }
+{FLOAT}               { yylval.f = std::strtof(yytext, nullptr); return T_FLOAT_LITERAL; }
 
-[0-9]+{EXPONENT}d     { yylval.d = std::strtod(yytext, nullptr); return T_DOUBLE_LITERAL; }
+{FLOAT}d              { yylval.d = std::strtod(yytext, nullptr); return T_DOUBLE_LITERAL; }
 
 0x[0-9a-fA-F]+        { yylval.i = readUInt(yytext, 16); return T_INT_LITERAL; }
 
@@ -87,6 +231,7 @@ EXPONENT        ([Ee]("-"|"+")?[0-9]+)
 as      { return T_AS; }
 var     { return T_VAR; }
 const   { return T_CONST; }
+override { return T_OVERRIDE; }
 false   { return T_FALSE; }
 null    { return T_NULL; }
 true    { return T_TRUE; }
@@ -118,6 +263,9 @@ hostwriteable { return T_HOSTWRITEABLE; }
 using   { return T_USING; }
 inline  { return T_INLINE; }
 unfilterable { return T_UNFILTERABLE; }
+dynamic { return T_DYNAMIC; }
+indirect { return T_INDIRECT; }
+workgroup { return T_WORKGROUP; }
 
 int     { return T_INT; }
 uint    { return T_UINT; }
@@ -65,7 +65,7 @@ static void EndBlock();
 static Expr* Load(Expr* expr);
 static Stmt* Store(Expr* expr, Expr* value);
 static Expr* MakeNewExpr(UnresolvedInitializer* initializer, Expr* length = nullptr);
-static Expr* InlineFile(const char* filename);
+static Expr* InlineFile(const char* filename, ASTType* type = nullptr);
 static Expr* StringLiteral(const char* str);
 
 template <typename T, typename... ARGS> T* Make(ARGS&&... args) {
@@ -132,14 +132,15 @@ static void DefineType(std::string id, ASTType* type) {
 %token <i> T_INT_LITERAL T_UINT_LITERAL
 %token <f> T_FLOAT_LITERAL
 %token <d> T_DOUBLE_LITERAL
+%token <expr> T_PACKED_LIST_LITERAL
 %token T_TRUE T_FALSE T_NULL T_IF T_ELSE T_FOR T_WHILE T_DO T_RETURN T_NEW
-%token T_CLASS T_ENUM T_VAR T_CONST T_AS
+%token T_CLASS T_ENUM T_VAR T_CONST T_OVERRIDE T_AS
 %token T_READONLY T_WRITEONLY T_COHERENT T_DEVICEONLY T_HOSTREADABLE T_HOSTWRITEABLE
 %token T_INT T_UINT T_FLOAT T_DOUBLE T_BOOL T_BYTE T_UBYTE T_SHORT T_USHORT
 %token T_HALF
 %token T_STATIC T_VERTEX T_FRAGMENT T_COMPUTE T_THIS
 %token T_INDEX T_UNIFORM T_STORAGE T_SAMPLEABLE T_RENDERABLE
-%token T_USING T_INLINE T_UNFILTERABLE
+%token T_USING T_INLINE T_UNFILTERABLE T_DYNAMIC T_INDIRECT T_WORKGROUP
 %right '=' T_ADD_EQUALS T_SUB_EQUALS T_MUL_EQUALS T_DIV_EQUALS
 %left T_LOGICAL_OR
 %left T_LOGICAL_AND
@@ -152,7 +153,7 @@ static void DefineType(std::string id, ASTType* type) {
 %left '*' '/' '%'
 %left T_AS
 %right UNARYMINUS '!' T_PLUSPLUS T_MINUSMINUS T_DOTDOT ':' '@'
-%left '.' '[' ']' '(' ')' '{' '}'
+%left '.' '[' ']' '(' ')' '{' '}' T_PACKED_LIST_LITERAL
 %expect 2   /* we expect 2 shift/reduce: dangling-else, A<B */
 %%
 program:
@@ -339,6 +340,7 @@ class_body_decl:
                                             { $$ = MakeDestructor($1, $3, $6); }
   | var_decl_statement ';'                  { $$ = $1; }
   | const_decl_statement ';'                { $$ = $1; }
+  | T_OVERRIDE T_IDENTIFIER '=' expr ';'    { $$ = Make<ConstDecl>($2, $4, true); }
   | enum_decl ';'                           { $$ = 0; }
   | using_decl                              { $$ = 0; }
   ;
@@ -386,6 +388,9 @@ type_qualifier:
   | T_HOSTWRITEABLE                         { $$ = Type::Qualifier::HostWriteable; }
   | T_COHERENT                              { $$ = Type::Qualifier::Coherent; }
   | T_UNFILTERABLE                          { $$ = Type::Qualifier::Unfilterable; }
+  | T_DYNAMIC                               { $$ = Type::Qualifier::Dynamic; }
+  | T_INDIRECT                              { $$ = Type::Qualifier::Indirect; }
+  | T_WORKGROUP                             { $$ = Type::Qualifier::Workgroup; }
   ;
 
 type_qualifiers:
@@ -448,6 +453,7 @@ argument:
 initializer:
     type '(' arguments ')'                  { $$ = Make<UnresolvedInitializer>($1, $3, true); }
   | type '{' arguments '}'                  { $$ = Make<UnresolvedInitializer>($1, $3, false); }
+  | type T_PACKED_LIST_LITERAL              { $$ = Make<UnresolvedInitializer>($1, static_cast<PackedListExpr*>($2)->Expand(nodes_), false); }
   ;
 
 initializer_or_type:
@@ -495,6 +501,8 @@ expr:
   | '&' assignable %prec UNARYMINUS         { $$ = $2; }
   | opt_length T_NEW initializer_or_type    { $$ = MakeNewExpr($3, $1); }
   | T_INLINE '(' T_STRING_LITERAL ')'       { $$ = InlineFile($3); }
+  | T_INLINE T_LT type T_GT '(' T_STRING_LITERAL ')'
+                                            { $$ = InlineFile($6, $3); }
   | T_STRING_LITERAL                        { $$ = StringLiteral($1); }
   ;
 
@@ -505,6 +513,7 @@ opt_length:
 
 list_initializer:
     '{' arguments '}'                       { $$ = Make<UnresolvedListExpr>($2); }
+  | T_PACKED_LIST_LITERAL
   ;
 
 expr_or_list:
@@ -591,7 +600,7 @@ static Expr* MakeNewExpr(UnresolvedInitializer* initializer, Expr* length) {
   return Make<UnresolvedNewExpr>(initializer->GetType(), length, initializer->GetArgList(), initializer->IsConstructor());
 }
 
-static Expr* TryInlineFile(std::string dir, const char* filename) {
+static Data* TryInlineFile(std::string dir, const char* filename) {
   struct stat statbuf;
   std::string path = !dir.empty() ? dir + "/" + filename : filename;
   if (stat(path.c_str(), &statbuf) != 0) {
@@ -608,17 +617,22 @@ static Expr* TryInlineFile(std::string dir, const char* filename) {
   return Make<Data>(std::move(buffer), size);
 }
 
-static Expr* InlineFile(const char* filename) {
+static Expr* InlineFile(const char* filename, ASTType* type) {
+  Data* data = nullptr;
   for (auto path : includePaths_) {
-    if (Expr* e = TryInlineFile(path, filename)) {
-      return e;
-    }
+    if ((data = TryInlineFile(path, filename))) break;
   }
-  if (Expr* e = TryInlineFile("", filename)) {
-    return e;
+  if (!data) data = TryInlineFile("", filename);
+  if (!data) {
+    yyerrorf("file \"%s\" not found", filename);
+    return nullptr;
   }
-  yyerrorf("file \"%s\" not found", filename);
-  return nullptr;
+  return type ? static_cast<Expr*>(Make<UnresolvedData>(type, data)) : data;
+}
+
+Expr* MakePackedList(std::vector<uint32_t>&& values, std::vector<uint32_t>&& shape, bool isFloat) {
+  auto packedValues = std::make_shared<const std::vector<uint32_t>>(std::move(values));
+  return Make<PackedListExpr>(packedValues, 0, std::move(shape), isFloat);
 }
 
 static Expr* StringLiteral(const char* str) {
@@ -775,7 +789,8 @@ ASTClassTemplateInstance* MakeClassTemplateInstance(ASTType* type, ASTTypeList*
 static MethodDecl* MakeMethodDecl(int modifiers, ArgList* optWorkgroupSize, std::string id,
                                   Stmts* formalArguments, int thisQualifiers, ASTType* returnType,
                                   Expr* initializer, Stmts* body) {
-  std::array<uint32_t, 3> workgroupSize;
+  std::array<uint32_t, 3>    workgroupSize = {1, 1, 1};
+  std::array<std::string, 3> workgroupSizeOverrides;
   if (optWorkgroupSize) {
     auto args = optWorkgroupSize->GetArgs();
     if (!(modifiers & Method::Modifier::Compute)) {
@@ -785,19 +800,22 @@ static MethodDecl* MakeMethodDecl(int modifiers, ArgList* optWorkgroupSize, std:
     } else {
       for (int i = 0; i < args.size(); ++i) {
         Expr* expr = args[i]->GetExpr();
-        if (!expr->IsIntConstant()) {
+        if (expr->IsIntConstant()) {
+          workgroupSize[i] = static_cast<IntConstant*>(expr)->GetValue();
+        } else if (expr->IsUnresolvedIdentifier()) {
+          // Resolved against the class's overrides by the semantic pass.
+          workgroupSizeOverrides[i] = static_cast<UnresolvedIdentifier*>(expr)->GetID();
+        } else {
           yyerrorf("workgroup size is not an integer constant");
           break;
-        } else {
-          workgroupSize[i] = static_cast<IntConstant*>(expr)->GetValue();
         }
       }
     }
   } else if (modifiers & Method::Modifier::Compute) {
     yyerrorf("compute shader requires a workgroup size");
   }
-  return Make<MethodDecl>(modifiers, workgroupSize, id, formalArguments, thisQualifiers,
-                          returnType, initializer, body);
+  return Make<MethodDecl>(modifiers, workgroupSize, workgroupSizeOverrides, id, formalArguments,
+                          thisQualifiers, returnType, initializer, body);
 }
 
 static MethodDecl* MakeConstructor(int modifiers, ASTType* type, Stmts* formalArguments,
@@ -247,7 +247,8 @@ var writeGBuffersPipeline = new RenderPipeline<WriteGBuffers>(
   cullMode = CullMode.Back
 );
 
-var gBuffersDebugViewPipeline = new RenderPipeline<GBuffersDebugView>(device);
+// Only needed once the user switches modes, so let it compile in the background.
+var gBuffersDebugViewPipeline = new RenderPipeline<GBuffersDebugView>(device = device, async = true);
 var deferredRenderPipeline = new RenderPipeline<DeferredRender>(device);
 
 var writeGBufferPassDescriptor = WriteGBuffers{
@@ -49,6 +49,8 @@ class MipmapGeneratorCubePipeline<PF> : MipmapGeneratorPipeline {
   var bindings : *BindGroup<MipmapGeneratorCubeBindings>;
 };
 
+// Generates each mip level by rendering a bilinear-filtered quad from the level above.  All
+// levels (and faces) are recorded into a single command encoder and submitted once.
 class MipmapGenerator<PF> {
   static Generate(device : *Device, texture : *renderable sampleable Texture2D<PF>) {
     var resamplingPipeline = new RenderPipeline<MipmapGenerator2DPipeline<PF>>(device);
@@ -58,10 +60,10 @@ class MipmapGenerator<PF> {
     var bindings : MipmapGenerator2DBindings;
     bindings.sampler = new Sampler(device);
 
+    var encoder = new CommandEncoder(device);
     for (var mipLevel = 1u; mipLevel < mipCount; ++mipLevel) {
       bindings.texture = texture.CreateSampleableView(mipLevel - 1, 1u);
       var fb = texture.CreateRenderableView(mipLevel);
-      var encoder = new CommandEncoder(device);
       var renderPass = new RenderPass<MipmapGenerator2DPipeline<PF>>(encoder, {
         fragColor = fb.CreateColorOutput(LoadOp.Clear),
         bindings = new BindGroup<MipmapGenerator2DBindings>(device, &bindings)
@@ -69,8 +71,8 @@ class MipmapGenerator<PF> {
       renderPass.SetPipeline(resamplingPipeline);
       renderPass.Draw(6, 1, 0, 0);
       renderPass.End();
-      device.GetQueue().Submit(encoder.Finish());
     }
+    device.GetQueue().Submit(encoder.Finish());
   }
   static Generate(device : *Device, texture : *renderable sampleable TextureCube<PF>) {
     var resamplingPipeline = new RenderPipeline<MipmapGeneratorCubePipeline<PF>>(device);
@@ -78,14 +80,14 @@ class MipmapGenerator<PF> {
 
     var bindings : MipmapGeneratorCubeBindings;
     bindings.sampler = new Sampler(device);
-    bindings.uniforms = new uniform Buffer<uint>(device);
 
+    var encoder = new CommandEncoder(device);
     for (var face = 0u; face < 6u; ++face) {
+      // Each face gets its own uniform buffer, since every pass is executed at submit time.
+      bindings.uniforms = new uniform Buffer<uint>(device, &face);
       for (var mipLevel = 1u; mipLevel < mipCount; ++mipLevel) {
         bindings.texture = texture.CreateSampleableView(mipLevel - 1, 1u);
-        bindings.uniforms.Set(&face);
         var fb = texture.CreateRenderableView(face, mipLevel);
-        var encoder = new CommandEncoder(device);
         var renderPass = new RenderPass<MipmapGeneratorCubePipeline<PF>>(encoder, {
           fragColor = fb.CreateColorOutput(LoadOp.Clear),
           bindings = new BindGroup<MipmapGeneratorCubeBindings>(device, &bindings)
@@ -93,8 +95,175 @@ class MipmapGenerator<PF> {
         renderPass.SetPipeline(resamplingPipeline);
         renderPass.Draw(6, 1, 0, 0);
         renderPass.End();
-        device.GetQueue().Submit(encoder.Finish());
       }
     }
+    device.GetQueue().Submit(encoder.Finish());
+  }
+}
+
+class MipmapDownsampleUniforms {
+  var sourceSize : uint<2>;
+  var levelCount : uint;          // number of dest levels written by this dispatch (1 to 4)
+}
+
+class MipmapDownsampleBindings<PF> {
+  var source : *readonly storage Texture2D<PF>;
+  var dest1 : *writeonly storage Texture2D<PF>;
+  var dest2 : *writeonly storage Texture2D<PF>;
+  var dest3 : *writeonly storage Texture2D<PF>;
+  var dest4 : *writeonly storage Texture2D<PF>;
+  var uniforms : *uniform Buffer<MipmapDownsampleUniforms>;
+}
+
+// Box-filters up to four mip levels per dispatch.  Each invocation reduces a 2x2 block of the
+// source into the first dest level and keeps the result in workgroup memory; the next levels
+// are then reduced from the tile by 4x4, 2x2 and 1x1 subsets of the workgroup, so only the
+// source level is read from the texture.  Footprints are clamped to the last row and column of
+// the level above, so odd and non-power-of-two sizes stay in bounds; stores beyond a level's
+// edge are discarded.
+class MipmapDownsamplePipeline<PF> {
+  compute(8, 8, 1) main(cb : &ComputeBuiltins) {
+    var tile : workgroup [64]float<4>;
+    var b = bindings.Get();
+    var uniforms = b.uniforms.MapRead():;
+    var size = uniforms.sourceSize;
+    var last = size - uint<2>{1, 1};
+    var coord = cb.globalInvocationId.xy;
+    var p0 = Math.min(coord + coord, last);
+    var p1 = Math.min(p0 + uint<2>{1, 1}, last);
+    var texel = (b.source.Load(p0) + b.source.Load(uint<2>{p1.x, p0.y})
+               + b.source.Load(uint<2>{p0.x, p1.y}) + b.source.Load(p1)) * 0.25;
+    b.dest1.Store(coord, texel);
+    var local = cb.localInvocationId.xy;
+    var group = cb.workgroupId.xy;
+    tile[local.y * 8u + local.x] = texel;
+    size = uint<2>{Math.max(size.x / 2u, 1u), Math.max(size.y / 2u, 1u)};
+
+    // size is the size of the level held in the tile, n the width of its footprint there.
+    var n = 8u;
+    for (var level = 2u; level <= uniforms.levelCount; ++level) {
+      var prevLast = size - uint<2>{1, 1};
+      var prevOrigin = uint<2>{group.x * n, group.y * n};
+      size = uint<2>{Math.max(size.x / 2u, 1u), Math.max(size.y / 2u, 1u)};
+      n = n / 2u;
+      var dest = uint<2>{group.x * n + local.x, group.y * n + local.y};
+      var active = local.x < n && local.y < n && dest.x < size.x && dest.y < size.y;
+      var value = float<4>{0.0, 0.0, 0.0, 0.0};
+      System.WorkgroupBarrier();
+      if (active) {
+        var q0 = Math.min(dest + dest, prevLast) - prevOrigin;
+        var q1 = Math.min(dest + dest + uint<2>{1, 1}, prevLast) - prevOrigin;
+        value = (tile[q0.y * 8u + q0.x] + tile[q0.y * 8u + q1.x]
+               + tile[q1.y * 8u + q0.x] + tile[q1.y * 8u + q1.x]) * 0.25;
+      }
+      System.WorkgroupBarrier();
+      if (active) {
+        tile[local.y * 8u + local.x] = value;
+        if (level == 2u) {
+          b.dest2.Store(dest, value);
+        } else if (level == 3u) {
+          b.dest3.Store(dest, value);
+        } else {
+          b.dest4.Store(dest, value);
+        }
+      }
+    }
+  }
+  var bindings : *BindGroup<MipmapDownsampleBindings<PF>>;
+}
+
+class MipmapScratchTextures<PF> {
+  var a : *storage Texture2D<PF>;
+  var b : *storage Texture2D<PF>;
+  var c : *storage Texture2D<PF>;
+}
+
+// Generates mipmaps with compute shaders rather than a render pass per level.  The texture must
+// have the storage qualifier and a float pixel format which supports storage binding (e.g.
+// RGBA8unorm or RGBA16float).  Each dispatch writes up to four levels, and all dispatches are
+// recorded into one compute pass and submitted once.
+class ComputeMipmapGenerator<PF> {
+  static Generate(device : *Device, texture : *storage Texture2D<PF>) {
+    var textureSize = texture.GetSize();
+    var mipCount = 30 - Math.clz(Math.max(textureSize.x, textureSize.y));
+    var encoder = new CommandEncoder(device);
+    var computePass = new ComputePass<MipmapDownsamplePipeline<PF>>(encoder, {});
+    computePass.SetPipeline(new ComputePipeline<MipmapDownsamplePipeline<PF>>(device));
+    var scratch = ComputeMipmapGenerator<PF>.CreateScratch(device);
+    for (var mipLevel = 1u; mipLevel < mipCount; mipLevel += 4u) {
+      var levelCount = Math.min(mipCount - mipLevel, 4u);
+      var last = mipLevel + levelCount - 1u;
+      ComputeMipmapGenerator<PF>.Downsample(device, computePass,
+                                            texture.CreateStorageView(mipLevel - 1u),
+                                            texture.CreateStorageView(mipLevel),
+                                            ComputeMipmapGenerator<PF>.LevelOrScratch(texture, mipLevel + 1u, last, scratch.a),
+                                            ComputeMipmapGenerator<PF>.LevelOrScratch(texture, mipLevel + 2u, last, scratch.b),
+                                            ComputeMipmapGenerator<PF>.LevelOrScratch(texture, mipLevel + 3u, last, scratch.c),
+                                            texture.GetSize(mipLevel - 1u),
+                                            texture.GetSize(mipLevel), levelCount);
+    }
+    computePass.End();
+    device.GetQueue().Submit(encoder.Finish());
+  }
+  static Generate(device : *Device, texture : *storage TextureCube<PF>) {
+    var mipCount = 30 - Math.clz(texture.GetSize().x);
+    var encoder = new CommandEncoder(device);
+    var computePass = new ComputePass<MipmapDownsamplePipeline<PF>>(encoder, {});
+    computePass.SetPipeline(new ComputePipeline<MipmapDownsamplePipeline<PF>>(device));
+    var scratch = ComputeMipmapGenerator<PF>.CreateScratch(device);
+    for (var face = 0u; face < 6u; ++face) {
+      for (var mipLevel = 1u; mipLevel < mipCount; mipLevel += 4u) {
+        var levelCount = Math.min(mipCount - mipLevel, 4u);
+        var last = mipLevel + levelCount - 1u;
+        ComputeMipmapGenerator<PF>.Downsample(device, computePass,
+                                              texture.CreateStorageView(face, mipLevel - 1u),
+                                              texture.CreateStorageView(face, mipLevel),
+                                              ComputeMipmapGenerator<PF>.LevelOrScratch(texture, face, mipLevel + 1u, last, scratch.a),
+                                              ComputeMipmapGenerator<PF>.LevelOrScratch(texture, face, mipLevel + 2u, last, scratch.b),
+                                              ComputeMipmapGenerator<PF>.LevelOrScratch(texture, face, mipLevel + 3u, last, scratch.c),
+                                              texture.GetSize(mipLevel - 1u),
+                                              texture.GetSize(mipLevel), levelCount);
+      }
+    }
+    computePass.End();
+    device.GetQueue().Submit(encoder.Finish());
+  }
+  // A dispatch writing fewer than four levels binds 1x1 scratch textures to its unused dest
+  // slots.  They must be distinct, since one subresource can't be bound to several writeonly
+  // storage slots of a bind group.  The kernel never stores to them.
+  static CreateScratch(device : *Device) : MipmapScratchTextures<PF> {
+    return MipmapScratchTextures<PF>{
+      new storage Texture2D<PF>(device, {1, 1}),
+      new storage Texture2D<PF>(device, {1, 1}),
+      new storage Texture2D<PF>(device, {1, 1})
+    };
+  }
+  static LevelOrScratch(texture : *storage Texture2D<PF>, mipLevel : uint, last : uint,
+                        scratch : *storage Texture2D<PF>) : *storage Texture2D<PF> {
+    if (mipLevel <= last) { return texture.CreateStorageView(mipLevel); }
+    return scratch.CreateStorageView();
+  }
+  static LevelOrScratch(texture : *storage TextureCube<PF>, face : uint, mipLevel : uint,
+                        last : uint, scratch : *storage Texture2D<PF>) : *storage Texture2D<PF> {
+    if (mipLevel <= last) { return texture.CreateStorageView(face, mipLevel); }
+    return scratch.CreateStorageView();
+  }
+  static Downsample(device : *Device, computePass : *ComputePass<MipmapDownsamplePipeline<PF>>,
+                    source : *storage Texture2D<PF>,
+                    dest1 : *storage Texture2D<PF>, dest2 : *storage Texture2D<PF>,
+                    dest3 : *storage Texture2D<PF>, dest4 : *storage Texture2D<PF>,
+                    sourceSize : uint<2>, destSize : uint<2>, levelCount : uint) {
+    var uniforms = MipmapDownsampleUniforms{sourceSize, levelCount};
+    computePass.Set({
+      bindings = new BindGroup<MipmapDownsampleBindings<PF>>(device, {
+        source = source,
+        dest1 = dest1,
+        dest2 = dest2,
+        dest3 = dest3,
+        dest4 = dest4,
+        uniforms = new uniform Buffer<MipmapDownsampleUniforms>(device, &uniforms)
+      })
+    });
+    computePass.Dispatch((destSize.x + 7u) / 8u, (destSize.y + 7u) / 8u, 1);
   }
 }
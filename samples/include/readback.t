@@ -0,0 +1,40 @@
+// Multi-buffered GPU-to-host readback.  Each frame, Copy() records a copy into the next of
+// several staging buffers, and Request() (after the submit) starts mapping it without waiting.
+// Get() returns the newest copy that has already arrived, typically a frame or two old, so the
+// transfer overlaps with the following frames instead of stalling the host.
+class Readback<T> {
+  Readback(device : *Device, length : uint) {
+    for (var i = 0; i < 3; ++i) {
+      buffers[i] = new hostreadable Buffer<[]T>(device, length);
+    }
+  }
+  Copy(encoder : *CommandEncoder, source : *Buffer<[]T>) {
+    if (pending[next]) {
+      // The GPU is three frames behind; wait for the oldest copy and discard it.
+      pending[next] = false;
+      buffers[next].MapRead();
+    }
+    buffers[next].CopyFromBuffer(encoder, source);
+  }
+  Request() {
+    buffers[next].MapReadAsync();
+    pending[next] = true;
+    next = (next + 1) % 3;
+  }
+  Get() : *readonly []T {
+    var result : *readonly []T;
+    System.ProcessEvents();
+    // Oldest first, so that every completed copy is unmapped except the newest.
+    for (var i = 0; i < 3; ++i) {
+      var j = (next + i) % 3;
+      if (pending[j] && buffers[j].IsMapped()) {
+        pending[j] = false;
+        result = buffers[j].MapRead();
+      }
+    }
+    return result;
+  }
+  var buffers : [3]*hostreadable Buffer<[]T>;
+  var pending : [3]bool;
+  var next : int;
+}
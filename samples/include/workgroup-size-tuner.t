@@ -0,0 +1,55 @@
+// Benchmarks candidate workgroup sizes for a compute kernel whose size is an override:
+//
+//   class Kernel {
+//     override groupSize = 64u;
+//     compute(groupSize, 1, 1) main(cb : &ComputeBuiltins) { ... }
+//   }
+//
+// Each candidate is compiled into its own pipeline and timed over a few dispatches that cover
+// numInvocations invocations, so the kernel must bounds-check its global invocation id.  Tune()
+// returns the fastest size, which can then be passed to Pipeline() for the real workload.
+// Timing uses GPU timestamps; on devices without them every candidate measures zero and the
+// first is returned.
+class WorkgroupSizeTuner<T> {
+  WorkgroupSizeTuner(device : *Device, specId = 0u) {
+    this.device = device;
+    this.specId = specId;
+    profiler = new Profiler(device);
+  }
+  Pipeline(size : uint) : *ComputePipeline<T> {
+    var constants = [1] new PipelineConstant;
+    constants[0].id = specId;
+    constants[0].value = size as double;
+    return new ComputePipeline<T>(device, false, constants);
+  }
+  Tune(data : &T, numInvocations : uint, candidates : &[]uint, iterations = 8) : uint {
+    var best = candidates[0];
+    var bestTime = 0.0d;
+    for (var i = 0; i < candidates.length; ++i) {
+      var size = candidates[i];
+      var pipeline = this.Pipeline(size);
+      var encoder = new CommandEncoder(device);
+      var computePass = new ComputePass<T>(encoder, data, profiler.Timestamps("tune"));
+      computePass.SetPipeline(pipeline);
+      for (var j = 0; j < iterations; ++j) {
+        computePass.Dispatch((numInvocations + size - 1u) / size, 1, 1);
+      }
+      computePass.End();
+      profiler.Resolve(encoder);
+      device.GetQueue().Submit(encoder.Finish());
+      profiler.ReadAsync();
+      while (!profiler.Update()) {
+        System.ProcessEvents();
+      }
+      var time = profiler.GetDuration("tune");
+      if (i == 0 || time < bestTime) {
+        best = size;
+        bestTime = time;
+      }
+    }
+    return best;
+  }
+  var device : *Device;
+  var specId : uint;
+  var profiler : *Profiler;
+}
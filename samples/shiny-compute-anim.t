@@ -15,7 +15,7 @@ class Vertex {
 
 var device = new Device();
 
-var texture = new sampleable renderable TextureCube<RGBA8unorm>(device, {2176, 2176}, 12);
+var texture = new sampleable storage TextureCube<RGBA8unorm>(device, {2176, 2176}, 12);
 var loader = CubeLoader<RGBA8unorm>{device, texture};
 loader.Load(inline("third_party/home-cube/right.jpg"), 0);
 loader.Load(inline("third_party/home-cube/left.jpg"), 1);
@@ -24,7 +24,7 @@ loader.Load(inline("third_party/home-cube/bottom.jpg"), 3);
 loader.Load(inline("third_party/home-cube/front.jpg"), 4);
 loader.Load(inline("third_party/home-cube/back.jpg"), 5);
 
-MipmapGenerator<RGBA8unorm>.Generate(device, texture);
+ComputeMipmapGenerator<RGBA8unorm>.Generate(device, texture);
 
 var window = new Window(System.GetScreenSize());
 var swapChain = new SwapChain<PreferredPixelFormat>(device, window);
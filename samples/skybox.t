@@ -71,6 +71,12 @@ var cubeBindings = Bindings{
   textureView = texture.CreateSampleableView()
 };
 var cubeBindGroup = new BindGroup<Bindings>(device, &cubeBindings);
+var skyboxBundle = new RenderBundle<SkyboxPipeline>(device,
+  { vertices = cubeInput, indices = cubeIB, bindings = cubeBindGroup }
+);
+skyboxBundle.SetPipeline(cubePipeline);
+skyboxBundle.DrawIndexed(cubeIndices.length, 1, 0, 0, 0);
+skyboxBundle.Finish();
 
 var handler = EventHandler{ distance = 10.0 };
 var windowSize = window.GetSize();
@@ -91,12 +97,9 @@ while (System.IsRunning()) {
   var p : SkyboxPipeline;
   var fb = swapChain.GetCurrentTexture().CreateColorOutput(LoadOp.Clear);
   var db = depthBuffer.CreateDepthStencilOutput(LoadOp.Clear);
-  var renderPass = new RenderPass<SkyboxPipeline>(encoder,
-    { fragColor = fb, depth = db, vertices = cubeInput, indices = cubeIB, bindings = cubeBindGroup }
-  );
+  var renderPass = new RenderPass<SkyboxPipeline>(encoder, { fragColor = fb, depth = db });
 
-  renderPass.SetPipeline(cubePipeline);
-  renderPass.DrawIndexed(cubeIndices.length, 1, 0, 0, 0);
+  renderPass.ExecuteBundle(skyboxBundle);
 
   renderPass.End();
   var cb = encoder.Finish();
@@ -0,0 +1,21 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+var device = new Device();
+var buffer = new storage Buffer<[]int>(device, 1);
+
+new BindGroup<ComputeBindings>(device, {buffer = buffer});
+var misses = device.GetCacheMisses();
+var hits = device.GetCacheHits();
+for (var i = 0; i < 3; ++i) {
+  new BindGroup<ComputeBindings>(device, {buffer = buffer});
+}
+Test.Expect(device.GetCacheMisses() == misses);
+Test.Expect(device.GetCacheHits() == hits + 3u);
+
+var other = new storage Buffer<[]int>(device, 1);
+new BindGroup<ComputeBindings>(device, {buffer = other});
+Test.Expect(device.GetCacheMisses() > misses);
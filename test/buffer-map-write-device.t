@@ -0,0 +1,95 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *hostwriteable storage Buffer<[]uint>;
+}
+
+class Compute {
+  compute(4, 1, 1) main(cb : &ComputeBuiltins) {
+    var i = cb.globalInvocationId.x;
+    bindings.Get().buffer.Map()[i] = i + 200u;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+class Check {
+  static Expect(device : *Device, buffer : *hostwriteable storage Buffer<[]uint>,
+                first : uint, last : uint) {
+    var hostBuf = new hostreadable Buffer<[]uint>(device, 4);
+    var encoder = new CommandEncoder(device);
+    hostBuf.CopyFromBuffer(encoder, buffer);
+    device.GetQueue().Submit(encoder.Finish());
+    var result = hostBuf.MapRead();
+    Test.Expect(result[0] == first);
+    Test.Expect(result[3] == last);
+  }
+}
+
+var device = new Device();
+var buffer = new hostwriteable storage Buffer<[]uint>(device, 4);
+
+// Each map goes through an upload buffer, copied in when the view is released.
+var data = buffer.MapWrite();
+for (var i = 0u; i < 4u; ++i) {
+  data[i] = i * 3u;
+}
+data = null;
+Check.Expect(device, buffer, 0u, 9u);
+
+data = buffer.MapWrite();
+for (var i = 0u; i < 4u; ++i) {
+  data[i] = i + 100u;
+}
+data = null;
+Check.Expect(device, buffer, 100u, 103u);
+
+// A third map reuses an upload buffer once its previous copy has been submitted.
+data = buffer.MapWrite();
+for (var i = 0u; i < 4u; ++i) {
+  data[i] = i + 300u;
+}
+data = null;
+Check.Expect(device, buffer, 300u, 303u);
+
+// Maps with no submit in between each get their own upload buffer; the copies land in order.
+data = buffer.MapWrite();
+for (var i = 0u; i < 4u; ++i) {
+  data[i] = i + 400u;
+}
+data = null;
+data = buffer.MapWrite();
+for (var i = 0u; i < 4u; ++i) {
+  data[i] = i + 500u;
+}
+data = null;
+Check.Expect(device, buffer, 500u, 503u);
+
+// Set and SetRange while a view is outstanding write through it.
+data = buffer.MapWrite();
+for (var i = 0u; i < 4u; ++i) {
+  data[i] = 0u;
+}
+var values = [4]uint{10u, 11u, 12u, 13u};
+buffer.Set(&values);
+var update = [1]uint{20u};
+buffer.SetRange(3u, &update);
+data = null;
+Check.Expect(device, buffer, 10u, 20u);
+
+// Set and SetRange on a buffer which has never been mapped.
+var fresh = new hostwriteable storage Buffer<[]uint>(device, 4);
+fresh.Set(&values);
+fresh.SetRange(3u, &update);
+Check.Expect(device, fresh, 10u, 20u);
+
+// An unwritten hostwriteable buffer can be bound and used in a pass.
+var unwritten = new hostwriteable storage Buffer<[]uint>(device, 4);
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Compute>(encoder, {
+  bindings = new BindGroup<ComputeBindings>(device, {buffer = unwritten})
+});
+computePass.SetPipeline(new ComputePipeline<Compute>(device));
+computePass.Dispatch(1, 1, 1);
+computePass.End();
+device.GetQueue().Submit(encoder.Finish());
+Check.Expect(device, unwritten, 200u, 203u);
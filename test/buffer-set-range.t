@@ -0,0 +1,21 @@
+#include "include/test.t"
+
+var device = new Device();
+var values = [4]int{1, 2, 3, 4};
+var buffer = new hostreadable Buffer<[]int>(device, &values);
+var update = [2]int{7, 8};
+buffer.SetRange(1u, &update);
+var result = buffer.MapRead();
+Test.Expect(result[0] == 1);
+Test.Expect(result[1] == 7);
+Test.Expect(result[2] == 8);
+Test.Expect(result[3] == 4);
+result = null;
+
+// Out-of-range writes and SetRange() on a plain buffer are reported and ignored.
+buffer.SetRange(3u, &update);
+var plain = new uniform Buffer<float<4>>(device);
+var value = float<4>(1.0, 2.0, 3.0, 4.0);
+plain.SetRange(0u, &value);
+result = buffer.MapRead();
+Test.Expect(result[3] == 4);
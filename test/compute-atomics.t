@@ -0,0 +1,63 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var counters : *storage Buffer<[]Atomic<uint>>;
+}
+
+class Atomics {
+  compute(64, 1, 1) main(cb : &ComputeBuiltins) {
+    var hist : workgroup [2]Atomic<uint>;
+    var counters = bindings.Get().counters.Map();
+    var i = cb.globalInvocationId.x;
+    var lid = cb.localInvocationIndex;
+    if (lid < 2u) hist[lid].Store(0u);
+    System.WorkgroupBarrier();
+    counters[0].Add(1u);
+    counters[1].Max(i);
+    counters[2].CompareExchange(0u, 7u);
+    counters[3].Or(i);
+    counters[4].Exchange(5u);
+    hist[i % 2u].Add(1u);
+    System.WorkgroupBarrier();
+    if (lid == 0u) {
+      counters[5].Add(hist[0].Load());
+      counters[6].Add(hist[1].Load());
+    }
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+var storageBuf = new storage Buffer<[]Atomic<uint>>(device, 7);
+var hostBuf = new hostreadable Buffer<[]Atomic<uint>>(device, 7);
+
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Atomics>(encoder, {
+  bindings = new BindGroup<ComputeBindings>(device, {counters = storageBuf})
+});
+computePass.SetPipeline(new ComputePipeline<Atomics>(device));
+computePass.Dispatch(2, 1, 1);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+Test.Expect(result[0].Load() == 128u);
+Test.Expect(result[1].Load() == 127u);
+Test.Expect(result[2].Load() == 7u);
+Test.Expect(result[3].Load() == 127u);
+Test.Expect(result[4].Load() == 5u);
+Test.Expect(result[5].Load() == 64u);
+Test.Expect(result[6].Load() == 64u);
+
+var a : Atomic<int>;
+Test.Expect(a.Add(5) == 0);
+Test.Expect(a.Min(-3) == 5);
+Test.Expect(a.Max(2) == -3);
+Test.Expect(a.Xor(3) == 2);
+Test.Expect(a.And(6) == 1);
+Test.Expect(a.CompareExchange(1, 9) == 0);
+Test.Expect(a.CompareExchange(0, 9) == 0);
+Test.Expect(a.Exchange(4) == 9);
+a.Store(-1);
+Test.Expect(a.Load() == -1);
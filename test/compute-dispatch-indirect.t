@@ -0,0 +1,52 @@
+#include "include/test.t"
+
+class ArgsBindings {
+  var args : *storage Buffer<[]uint>;
+}
+
+class WriteArgs {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var args = bindings.Get().args.Map();
+    args[0] = 2u;
+    args[1] = 1u;
+    args[2] = 1u;
+  }
+  var bindings : *BindGroup<ArgsBindings>;
+}
+
+class ResultBindings {
+  var result : *storage Buffer<[]int>;
+}
+
+class Fill {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    bindings.Get().result.Map()[cb.globalInvocationId.x] = 1;
+  }
+  var bindings : *BindGroup<ResultBindings>;
+}
+
+var device = new Device();
+var argsBuf = new indirect storage Buffer<[]uint>(device, 3);
+var storageBuf = new storage Buffer<[]int>(device, 3);
+var hostBuf = new hostreadable Buffer<[]int>(device, 3);
+
+var encoder = new CommandEncoder(device);
+var argsPass = new ComputePass<WriteArgs>(encoder, {
+  bindings = new BindGroup<ArgsBindings>(device, {args = argsBuf})
+});
+argsPass.SetPipeline(new ComputePipeline<WriteArgs>(device));
+argsPass.Dispatch(1, 1, 1);
+argsPass.End();
+var fillPass = new ComputePass<Fill>(encoder, {
+  bindings = new BindGroup<ResultBindings>(device, {result = storageBuf})
+});
+fillPass.SetPipeline(new ComputePipeline<Fill>(device));
+fillPass.DispatchIndirect(argsBuf);
+fillPass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+Test.Expect(result[0] == 1);
+Test.Expect(result[1] == 1);
+Test.Expect(result[2] == 0);
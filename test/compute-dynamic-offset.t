@@ -0,0 +1,46 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var uniforms : *dynamic uniform Buffer<int<2>>;
+  var result : *storage Buffer<[]int>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var b = bindings.Get();
+    var u = b.uniforms.MapRead():;
+    b.result.MapWrite()[u.x] = u.y;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+var computePipeline = new ComputePipeline<Compute>(device);
+
+var uniforms = new dynamic uniform Buffer<int<2>>(device, 3u);
+for (var i = 0; i < 3; ++i) {
+  var value = int<2>(i, 10 * (i + 1));
+  uniforms.SetRange(i as uint, &value);
+}
+var storageBuf = new storage Buffer<[]int>(device, 3);
+var hostBuf = new hostreadable Buffer<[]int>(device, 3);
+
+var bg = new BindGroup<ComputeBindings>(device, {uniforms = uniforms, result = storageBuf});
+
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Compute>(encoder, {bindings = bg});
+computePass.SetPipeline(computePipeline);
+for (var i = 0u; i < 3u; ++i) {
+  var elementIndices = [1]uint{i};
+  computePass.SetDynamic({bindings = bg}, &elementIndices);
+  computePass.Dispatch(1, 1, 1);
+}
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+Test.Expect(result[0] == 10);
+Test.Expect(result[1] == 20);
+Test.Expect(result[2] == 30);
@@ -0,0 +1,102 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var result : *storage Buffer<[]uint>;
+}
+
+class Scale {
+  override groupSize = 64u;
+  override scale = 1u;
+  override offset = false;
+  override bias = 0.0;
+  compute(groupSize, 1, 1) main(cb : &ComputeBuiltins) {
+    var i = cb.globalInvocationId.x;
+    if (i < 256u) {
+      var value = i * scale + bias as uint;
+      if (offset) value += 1000u;
+      bindings.Get().result.Map()[i] = value;
+    }
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+var storageBuf = new storage Buffer<[]uint>(device, 256);
+var hostBuf = new hostreadable Buffer<[]uint>(device, 256);
+var bindings = new BindGroup<ComputeBindings>(device, {result = storageBuf});
+
+// The host sees each override's default value.
+Test.Expect(Scale.groupSize == 64u);
+Test.Expect(Scale.scale == 1u);
+Test.Expect(Scale.bias == 0.0);
+
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Scale>(encoder, {bindings = bindings});
+computePass.SetPipeline(new ComputePipeline<Scale>(device));
+computePass.Dispatch(4, 1, 1);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+Test.Expect(result[0] == 0u);
+Test.Expect(result[255] == 255u);
+result = null;
+
+// Overrides are numbered in declaration order.
+var constants = [4] new PipelineConstant;
+constants[0].id = 0u;
+constants[0].value = 32.0d;
+constants[1].id = 1u;
+constants[1].value = 3.0d;
+constants[2].id = 2u;
+constants[2].value = 1.0d;
+constants[3].id = 3u;
+constants[3].value = 2.0d;
+
+encoder = new CommandEncoder(device);
+computePass = new ComputePass<Scale>(encoder, {bindings = bindings});
+computePass.SetPipeline(new ComputePipeline<Scale>(device, false, constants));
+computePass.Dispatch(8, 1, 1);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+result = hostBuf.MapRead();
+Test.Expect(result[0] == 1002u);
+Test.Expect(result[1] == 1005u);
+Test.Expect(result[255] == 1767u);
+result = null;
+
+// Another class's override is not part of this pipeline, so it keeps its default value
+// rather than sharing SpecId 0 with the pipeline's own override.
+class Other {
+  override extra = 7u;
+}
+
+class Borrow {
+  override own = 0u;
+  compute(64, 1, 1) main(cb : &ComputeBuiltins) {
+    var i = cb.globalInvocationId.x;
+    if (i < 256u) {
+      bindings.Get().result.Map()[i] = own * 1000u + Other.extra;
+    }
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var ownConstant = [1] new PipelineConstant;
+ownConstant[0].id = 0u;
+ownConstant[0].value = 2.0d;
+
+encoder = new CommandEncoder(device);
+var borrowPass = new ComputePass<Borrow>(encoder, {bindings = bindings});
+borrowPass.SetPipeline(new ComputePipeline<Borrow>(device, false, ownConstant));
+borrowPass.Dispatch(4, 1, 1);
+borrowPass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+result = hostBuf.MapRead();
+Test.Expect(result[0] == 2007u);
+Test.Expect(result[255] == 2007u);
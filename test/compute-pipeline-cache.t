@@ -0,0 +1,23 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    bindings.Get().buffer.MapWrite()[0] = 1;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+new ComputePipeline<Compute>(device);
+var misses = device.GetCacheMisses();
+var hits = device.GetCacheHits();
+for (var i = 0; i < 3; ++i) {
+  new ComputePipeline<Compute>(device);
+}
+Test.Expect(device.GetCacheMisses() == misses);
+Test.Expect(device.GetCacheHits() == hits + 3u);
@@ -0,0 +1,57 @@
+#include "include/test.t"
+
+class FillBindings {
+  var dest : *writeonly storage Texture2D<R32float>;
+}
+
+class Fill {
+  compute(4, 4, 1) main(cb : &ComputeBuiltins) {
+    var coord = cb.globalInvocationId.xy;
+    var value = (coord.y * 4u + coord.x) as float;
+    bindings.Get().dest.Store(coord, float<4>{value, 0.0, 0.0, 1.0});
+  }
+  var bindings : *BindGroup<FillBindings>;
+}
+
+class ReadBackBindings {
+  var source : *readonly storage Texture2D<R32float>;
+  var result : *storage Buffer<[]float>;
+}
+
+class ReadBack {
+  compute(4, 4, 1) main(cb : &ComputeBuiltins) {
+    var b = bindings.Get();
+    var coord = cb.globalInvocationId.xy;
+    b.result.Map()[coord.y * 4u + coord.x] = b.source.Load(coord).x;
+  }
+  var bindings : *BindGroup<ReadBackBindings>;
+}
+
+var device = new Device();
+var texture = new storage Texture2D<R32float>(device, {4, 4});
+var storageBuf = new storage Buffer<[]float>(device, 16);
+var hostBuf = new hostreadable Buffer<[]float>(device, 16);
+
+var encoder = new CommandEncoder(device);
+var fillPass = new ComputePass<Fill>(encoder, {
+  bindings = new BindGroup<FillBindings>(device, {dest = texture.CreateStorageView()})
+});
+fillPass.SetPipeline(new ComputePipeline<Fill>(device));
+fillPass.Dispatch(1, 1, 1);
+fillPass.End();
+
+var readBackPass = new ComputePass<ReadBack>(encoder, {
+  bindings = new BindGroup<ReadBackBindings>(device, {
+    source = texture.CreateStorageView(), result = storageBuf
+  })
+});
+readBackPass.SetPipeline(new ComputePipeline<ReadBack>(device));
+readBackPass.Dispatch(1, 1, 1);
+readBackPass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+Test.Expect(result[0] == 0.0);
+Test.Expect(result[5] == 5.0);
+Test.Expect(result[15] == 15.0);
@@ -0,0 +1,51 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var errors : *storage Buffer<[]uint>;
+}
+
+class Subgroups {
+  compute(64, 1, 1) main(cb : &ComputeBuiltins) {
+    var i = cb.globalInvocationId.x;
+    var id = Subgroup.InvocationId();
+    var size = Subgroup.Size();
+    var sum = Subgroup.Add(1u);
+    var inclusive = Subgroup.InclusiveAdd(1u);
+    var exclusive = Subgroup.ExclusiveAdd(1u);
+    var shuffled = Subgroup.Shuffle(i, id);
+    var first = Subgroup.Broadcast(id, 0u);
+    var ballot = Subgroup.Ballot(true);
+    var errors = 0u;
+    if (sum != size) errors = errors + 1u;
+    if (inclusive != id + 1u) errors = errors + 1u;
+    if (exclusive != id) errors = errors + 1u;
+    if (shuffled != i) errors = errors + 1u;
+    if (first != 0u) errors = errors + 1u;
+    if (!Math.any(ballot != uint<4>(0u, 0u, 0u, 0u))) errors = errors + 1u;
+    bindings.Get().errors.Map()[i] = errors;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+// Adapters without subgroup support can't create the pipeline; a real program would pick a
+// shared-memory fallback here instead.
+if (Subgroup.IsSupported(device)) {
+  var storageBuf = new storage Buffer<[]uint>(device, 64);
+  var hostBuf = new hostreadable Buffer<[]uint>(device, 64);
+  var encoder = new CommandEncoder(device);
+  var computePass = new ComputePass<Subgroups>(encoder, {
+    bindings = new BindGroup<ComputeBindings>(device, {errors = storageBuf})
+  });
+  computePass.SetPipeline(new ComputePipeline<Subgroups>(device));
+  computePass.Dispatch(1, 1, 1);
+  computePass.End();
+  hostBuf.CopyFromBuffer(encoder, storageBuf);
+  device.GetQueue().Submit(encoder.Finish());
+
+  var result = hostBuf.MapRead();
+  for (var j = 0; j < 64; ++j) {
+    Test.Expect(result[j] == 0u);
+  }
+}
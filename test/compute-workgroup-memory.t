@@ -0,0 +1,38 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var result : *storage Buffer<[]uint>;
+}
+
+class Reduce {
+  compute(64, 1, 1) main(cb : &ComputeBuiltins) {
+    var tile : workgroup [64]uint;
+    var i = cb.localInvocationIndex;
+    tile[i] = cb.globalInvocationId.x + 1u;
+    System.WorkgroupBarrier();
+    for (var s = 32u; s > 0u; s = s / 2u) {
+      if (i < s) tile[i] = tile[i] + tile[i + s];
+      System.WorkgroupBarrier();
+    }
+    if (i == 0u) bindings.Get().result.Map()[cb.workgroupId.x] = tile[0];
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+var storageBuf = new storage Buffer<[]uint>(device, 2);
+var hostBuf = new hostreadable Buffer<[]uint>(device, 2);
+
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Reduce>(encoder, {
+  bindings = new BindGroup<ComputeBindings>(device, {result = storageBuf})
+});
+computePass.SetPipeline(new ComputePipeline<Reduce>(device));
+computePass.Dispatch(2, 1, 1);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+Test.Expect(result[0] == 2080u);
+Test.Expect(result[1] == 6176u);
@@ -0,0 +1,10 @@
+class Ptrs {
+  var p : *int;
+}
+
+var notArray = inline<int>("test/foo.txt");
+var tooShort = inline<[]float<3>>("test/foo.txt");
+var wrongLength = inline<[2]uint>("test/foo.txt");
+var bools = inline<[]bool>("test/foo.txt");
+var boolVectors = inline<[]bool<4>>("test/foo.txt");
+var ptrs = inline<[]Ptrs>("test/foo.txt");
@@ -14,3 +14,7 @@ var t : *Texture2D<RGBA8unorm>;
 var st : *sampleable Texture2D<RGBA8unorm> = t;
 var rt : *renderable Texture2D<RGBA8unorm> = t;
 var srt : *sampleable renderable Texture2D<RGBA8unorm> = t;
+
+var sb : *storage Buffer<[]uint>;
+var ind : *indirect Buffer<[]uint> = sb;
+var dyn : *dynamic uniform Buffer<float> = u;
@@ -0,0 +1,14 @@
+class Foo {
+  override groupSize = 64u;
+  override ratio = 0.5;
+  override wide = 2.0d;
+  compute(groupSize, 1, 1) cs1(cb : &ComputeBuiltins) {}
+  compute(missing, 1, 1) cs2(cb : &ComputeBuiltins) {}
+  compute(ratio) cs3(cb : &ComputeBuiltins) {}
+};
+
+class Bar : Foo {
+  override size = 1u;
+  override size = 2u;
+  override groupSize = 32u;
+};
@@ -8,6 +8,35 @@ class NoNewInShaders {
   }
 }
 
+class NoWorkgroupVarsInVertexShaders {
+  vertex main(vb : &VertexBuiltins) {
+    var scratch : workgroup [4]float;
+    scratch[0] = 1.0;
+  }
+  fragment main(fb : &FragmentBuiltins) {}
+}
+
+class NoDynamicBroadcast {
+  compute(1) main(cb : &ComputeBuiltins) {
+    var x = Subgroup.Broadcast(1u, cb.localInvocationIndex);
+  }
+}
+
+class NoWorkgroupVarsInShaderHelpers {
+  deviceonly static Helper() : float {
+    var scratch : workgroup [4]float;
+    scratch[0] = 1.0;
+    return scratch[0];
+  }
+  vertex main(vb : &VertexBuiltins) {}
+  fragment main(fb : &FragmentBuiltins) {
+    var x = NoWorkgroupVarsInShaderHelpers.Helper();
+  }
+}
+
 var device = new Device();
 
 new ComputePipeline<NoNewInShaders>(device);
+new RenderPipeline<NoWorkgroupVarsInVertexShaders>(device);
+new ComputePipeline<NoDynamicBroadcast>(device);
+new RenderPipeline<NoWorkgroupVarsInShaderHelpers>(device);
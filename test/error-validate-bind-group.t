@@ -17,3 +17,10 @@ class C {
 }
 new BindGroup<float>(device, null);
 new BindGroup<C>(device, {});
+class D {
+  var rw : *storage Texture2D<RGBA8unorm>;
+  var r32 : *storage Texture2D<R32float>;
+  var ro : *readonly storage Texture2D<RGBA8unorm>;
+  var wo : *writeonly storage Texture3D<RGBA8unorm>;
+}
+new BindGroup<D>(device, {});
@@ -48,9 +48,22 @@ new hostreadable index Buffer<[]uint>(device);
 new hostreadable storage Buffer<float>(device);
 new hostreadable uniform Buffer<float>(device);
 
-new hostwriteable vertex Buffer<[]uint>(device);
-new hostwriteable index Buffer<[]uint>(device);
-new hostwriteable storage Buffer<float>(device);
-new hostwriteable uniform Buffer<float>(device);
+new hostwriteable vertex Buffer<[]uint>(device); // should succeed
+new hostwriteable index Buffer<[]uint>(device); // should succeed
+new hostwriteable storage Buffer<float>(device); // should succeed
+new hostwriteable uniform Buffer<float>(device); // should succeed
 
 new sampleable renderable readonly writeonly unfilterable Buffer<float>(device);
+
+new dynamic vertex Buffer<[]float>(device);
+new dynamic Buffer<float>(device);
+new dynamic storage Buffer<[]float>(device);
+
+new indirect Buffer<uint>(device);
+new indirect Buffer<[]int>(device);
+new hostreadable indirect Buffer<[]uint>(device);
+new indirect Buffer<[]uint>(device); // should succeed
+
+new storage Buffer<[]Atomic<float>>(device);
+new uniform Buffer<Atomic<int>>(device);
+new storage Buffer<[]Atomic<uint>>(device); // should succeed
@@ -0,0 +1,8 @@
+class NoWorkgroupVarsInHostCode {
+  var field : workgroup int;
+  static Helper() {
+    var scratch : workgroup [4]float;
+  }
+}
+
+var global : workgroup int;
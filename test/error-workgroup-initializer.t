@@ -0,0 +1,18 @@
+#include "api.t"
+
+class WithDefaults {
+  var count = 1;
+}
+
+class WithoutDefaults {
+  var count : int;
+}
+
+class Compute {
+  compute(1) main(cb : &ComputeBuiltins) {
+    var a : workgroup int = 1;
+    var b : workgroup WithDefaults;
+    var c : workgroup [4]WithDefaults;
+    var d : workgroup WithoutDefaults;
+  }
+}
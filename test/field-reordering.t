@@ -0,0 +1,107 @@
+#include "include/test.t"
+
+// The test harness runs with -l, so that the fields of buffer contents are reordered to reduce
+// padding.
+
+class Uniforms {
+  var a : float;
+  var b : float<4>;
+  var c : float;
+  var d : float<2>;
+}
+
+class Inner {
+  var s : float;
+  var t : float<2>;
+  var u : float;
+}
+
+class Base {
+  var x : float;
+  var v : float<4>;
+}
+
+class Derived : Base {
+  var y : float;
+  var w : float<4>;
+  var n : Inner;
+  var z : float;
+}
+
+class ReadBackBindings {
+  var uniforms : *uniform Buffer<Uniforms>;
+  var data : *storage Buffer<Derived>;
+  var result : *storage Buffer<[]float>;
+}
+
+class ReadBack {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var b = bindings.Get();
+    var u = b.uniforms.MapRead();
+    var d = b.data.Map();
+    var r = b.result.Map();
+    r[0] = u.a;
+    r[1] = u.b.x;
+    r[2] = u.b.y;
+    r[3] = u.b.z;
+    r[4] = u.b.w;
+    r[5] = u.c;
+    r[6] = u.d.x;
+    r[7] = u.d.y;
+    r[8] = d.x;
+    r[9] = d.v.x;
+    r[10] = d.v.y;
+    r[11] = d.v.z;
+    r[12] = d.v.w;
+    r[13] = d.y;
+    r[14] = d.w.x;
+    r[15] = d.w.y;
+    r[16] = d.w.z;
+    r[17] = d.w.w;
+    r[18] = d.n.s;
+    r[19] = d.n.t.x;
+    r[20] = d.n.t.y;
+    r[21] = d.n.u;
+    r[22] = d.z;
+  }
+  var bindings : *BindGroup<ReadBackBindings>;
+}
+
+var device = new Device();
+
+var uniforms : Uniforms;
+uniforms.a = 1.0;
+uniforms.b = float<4>{2.0, 3.0, 4.0, 5.0};
+uniforms.c = 6.0;
+uniforms.d = float<2>{7.0, 8.0};
+
+var data : Derived;
+data.x = 9.0;
+data.v = float<4>{10.0, 11.0, 12.0, 13.0};
+data.y = 14.0;
+data.w = float<4>{15.0, 16.0, 17.0, 18.0};
+data.n.s = 19.0;
+data.n.t = float<2>{20.0, 21.0};
+data.n.u = 22.0;
+data.z = 23.0;
+
+var storageBuf = new storage Buffer<[]float>(device, 23);
+var hostBuf = new hostreadable Buffer<[]float>(device, 23);
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<ReadBack>(encoder, {
+  bindings = new BindGroup<ReadBackBindings>(device, {
+    uniforms = new uniform Buffer<Uniforms>(device, &uniforms),
+    data = new storage Buffer<Derived>(device, &data),
+    result = storageBuf
+  })
+});
+computePass.SetPipeline(new ComputePipeline<ReadBack>(device));
+computePass.Dispatch(1, 1, 1);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+for (var i = 0; i < 23; ++i) {
+  Test.Expect(result[i] == (i + 1) as float);
+}
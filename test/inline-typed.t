@@ -0,0 +1,31 @@
+#include "include/test.t"
+
+// test/foo.txt holds the four bytes "abc\n".
+var bytes = inline<[]ubyte<4>>("test/foo.txt");
+Test.Expect(bytes.length == 1);
+Test.Expect(bytes[0].x as int == 97);
+Test.Expect(bytes[0].w as int == 10);
+
+var sized = inline<[4]ubyte>("test/foo.txt");
+Test.Expect(sized[2] as int == 99);
+
+var halves = inline<[]ushort>("test/foo.txt");
+Test.Expect(halves.length == 2);
+Test.Expect(halves[0] == 25185us);
+Test.Expect(halves[1] == 2659us);
+
+var words = inline<[]uint>("test/foo.txt");
+Test.Expect(words.length == 1);
+Test.Expect(words[0] == 174285409u);
+
+class Chars {
+  var a : ubyte;
+  var b : ubyte;
+  var cd : ubyte<2>;
+}
+
+var chars = inline<[]Chars>("test/foo.txt");
+Test.Expect(chars.length == 1);
+Test.Expect(chars[0].a as int == 97);
+Test.Expect(chars[0].b as int == 98);
+Test.Expect(chars[0].cd.y as int == 10);
@@ -0,0 +1,287 @@
+#include "include/test.t"
+
+var ints : [100][3]int = {
+  {0, 1, -2},
+  {3, 4, -5},
+  {6, 7, -8},
+  {9, 10, -11},
+  {12, 13, -14},
+  {15, 16, -17},
+  {18, 19, -20},
+  {21, 22, -23},
+  {24, 25, -26},
+  {27, 28, -29},
+  {30, 31, -32},
+  {33, 34, -35},
+  {36, 37, -38},
+  {39, 40, -41},
+  {42, 43, -44},
+  {45, 46, -47},
+  {48, 49, -50},
+  {51, 52, -53},
+  {54, 55, -56},
+  {57, 58, -59},
+  {60, 61, -62},
+  {63, 64, -65},
+  {66, 67, -68},
+  {69, 70, -71},
+  {72, 73, -74},
+  {75, 76, -77},
+  {78, 79, -80},
+  {81, 82, -83},
+  {84, 85, -86},
+  {87, 88, -89},
+  {90, 91, -92},
+  {93, 94, -95},
+  {96, 97, -98},
+  {99, 100, -101},
+  {102, 103, -104},
+  {105, 106, -107},
+  {108, 109, -110},
+  {111, 112, -113},
+  {114, 115, -116},
+  {117, 118, -119},
+  {120, 121, -122},
+  {123, 124, -125},
+  {126, 127, -128},
+  {129, 130, -131},
+  {132, 133, -134},
+  {135, 136, -137},
+  {138, 139, -140},
+  {141, 142, -143},
+  {144, 145, -146},
+  {147, 148, -149},
+  {150, 151, -152},
+  {153, 154, -155},
+  {156, 157, -158},
+  {159, 160, -161},
+  {162, 163, -164},
+  {165, 166, -167},
+  {168, 169, -170},
+  {171, 172, -173},
+  {174, 175, -176},
+  {177, 178, -179},
+  {180, 181, -182},
+  {183, 184, -185},
+  {186, 187, -188},
+  {189, 190, -191},
+  {192, 193, -194},
+  {195, 196, -197},
+  {198, 199, -200},
+  {201, 202, -203},
+  {204, 205, -206},
+  {207, 208, -209},
+  {210, 211, -212},
+  {213, 214, -215},
+  {216, 217, -218},
+  {219, 220, -221},
+  {222, 223, -224},
+  {225, 226, -227},
+  {228, 229, -230},
+  {231, 232, -233},
+  {234, 235, -236},
+  {237, 238, -239},
+  {240, 241, -242},
+  {243, 244, -245},
+  {246, 247, -248},
+  {249, 250, -251},
+  {252, 253, -254},
+  {255, 256, -257},
+  {258, 259, -260},
+  {261, 262, -263},
+  {264, 265, -266},
+  {267, 268, -269},
+  {270, 271, -272},
+  {273, 274, -275},
+  {276, 277, -278},
+  {279, 280, -281},
+  {282, 283, -284},
+  {285, 286, -287},
+  {288, 289, -290},
+  {291, 292, -293},
+  {294, 295, -296},
+  {297, 298, -299}
+};
+Test.Expect(ints[0][1] == 1);
+Test.Expect(ints[99][2] == -299);
+
+var floats : [64]float<4> = {
+  {0.5, 0.25, -0.0, 1.0e-1},
+  {1.5, 1.25, -1.0, 1.0e-1},
+  {2.5, 2.25, -2.0, 1.0e-1},
+  {3.5, 3.25, -3.0, 1.0e-1},
+  {4.5, 4.25, -4.0, 1.0e-1},
+  {5.5, 5.25, -5.0, 1.0e-1},
+  {6.5, 6.25, -6.0, 1.0e-1},
+  {7.5, 7.25, -7.0, 1.0e-1},
+  {8.5, 8.25, -8.0, 1.0e-1},
+  {9.5, 9.25, -9.0, 1.0e-1},
+  {10.5, 10.25, -10.0, 1.0e-1},
+  {11.5, 11.25, -11.0, 1.0e-1},
+  {12.5, 12.25, -12.0, 1.0e-1},
+  {13.5, 13.25, -13.0, 1.0e-1},
+  {14.5, 14.25, -14.0, 1.0e-1},
+  {15.5, 15.25, -15.0, 1.0e-1},
+  {16.5, 16.25, -16.0, 1.0e-1},
+  {17.5, 17.25, -17.0, 1.0e-1},
+  {18.5, 18.25, -18.0, 1.0e-1},
+  {19.5, 19.25, -19.0, 1.0e-1},
+  {20.5, 20.25, -20.0, 1.0e-1},
+  {21.5, 21.25, -21.0, 1.0e-1},
+  {22.5, 22.25, -22.0, 1.0e-1},
+  {23.5, 23.25, -23.0, 1.0e-1},
+  {24.5, 24.25, -24.0, 1.0e-1},
+  {25.5, 25.25, -25.0, 1.0e-1},
+  {26.5, 26.25, -26.0, 1.0e-1},
+  {27.5, 27.25, -27.0, 1.0e-1},
+  {28.5, 28.25, -28.0, 1.0e-1},
+  {29.5, 29.25, -29.0, 1.0e-1},
+  {30.5, 30.25, -30.0, 1.0e-1},
+  {31.5, 31.25, -31.0, 1.0e-1},
+  {32.5, 32.25, -32.0, 1.0e-1},
+  {33.5, 33.25, -33.0, 1.0e-1},
+  {34.5, 34.25, -34.0, 1.0e-1},
+  {35.5, 35.25, -35.0, 1.0e-1},
+  {36.5, 36.25, -36.0, 1.0e-1},
+  {37.5, 37.25, -37.0, 1.0e-1},
+  {38.5, 38.25, -38.0, 1.0e-1},
+  {39.5, 39.25, -39.0, 1.0e-1},
+  {40.5, 40.25, -40.0, 1.0e-1},
+  {41.5, 41.25, -41.0, 1.0e-1},
+  {42.5, 42.25, -42.0, 1.0e-1},
+  {43.5, 43.25, -43.0, 1.0e-1},
+  {44.5, 44.25, -44.0, 1.0e-1},
+  {45.5, 45.25, -45.0, 1.0e-1},
+  {46.5, 46.25, -46.0, 1.0e-1},
+  {47.5, 47.25, -47.0, 1.0e-1},
+  {48.5, 48.25, -48.0, 1.0e-1},
+  {49.5, 49.25, -49.0, 1.0e-1},
+  {50.5, 50.25, -50.0, 1.0e-1},
+  {51.5, 51.25, -51.0, 1.0e-1},
+  {52.5, 52.25, -52.0, 1.0e-1},
+  {53.5, 53.25, -53.0, 1.0e-1},
+  {54.5, 54.25, -54.0, 1.0e-1},
+  {55.5, 55.25, -55.0, 1.0e-1},
+  {56.5, 56.25, -56.0, 1.0e-1},
+  {57.5, 57.25, -57.0, 1.0e-1},
+  {58.5, 58.25, -58.0, 1.0e-1},
+  {59.5, 59.25, -59.0, 1.0e-1},
+  {60.5, 60.25, -60.0, 1.0e-1},
+  {61.5, 61.25, -61.0, 1.0e-1},
+  {62.5, 62.25, -62.0, 1.0e-1},
+  {63.5, 63.25, -63.0, 1.0e-1}
+};
+Test.Expect(floats[1].x == 1.5);
+Test.Expect(floats[63].z == -63.0);
+Test.Expect(floats[2].w == 1.0e-1);
+
+var uints : [300]uint = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+  20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+  40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+  60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
+  80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99,
+  100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119,
+  120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139,
+  140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+  160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179,
+  180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199,
+  200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219,
+  220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+  240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255, 256, 257, 258, 259,
+  260, 261, 262, 263, 264, 265, 266, 267, 268, 269, 270, 271, 272, 273, 274, 275, 276, 277, 278, 279,
+  280, 281, 282, 283, 284, 285, 286, 287, 288, 289, 290, 291, 292, 293, 294, 295, 296, 297, 298, 299
+};
+Test.Expect(uints[299] == 299u);
+
+var widened : [300]float = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+  20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+  40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+  60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
+  80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99,
+  100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119,
+  120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139,
+  140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+  160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179,
+  180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199,
+  200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219,
+  220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+  240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255, 256, 257, 258, 259,
+  260, 261, 262, 263, 264, 265, 266, 267, 268, 269, 270, 271, 272, 273, 274, 275, 276, 277, 278, 279,
+  280, 281, 282, 283, 284, 285, 286, 287, 288, 289, 290, 291, 292, 293, 294, 295, 296, 297, 298, 299
+};
+Test.Expect(widened[150] == 150.0);
+
+
+// Exponent-only and leading-dot floats lex the same packed or not.
+var exponents : [64]float<4> = {
+  {0e1, 0E-1, .0, 0.5e+0},
+  {1e1, 1E-1, .1, 1.5e+0},
+  {2e1, 2E-1, .2, 2.5e+0},
+  {3e1, 3E-1, .3, 3.5e+0},
+  {4e1, 4E-1, .4, 4.5e+0},
+  {5e1, 5E-1, .5, 5.5e+0},
+  {6e1, 6E-1, .6, 6.5e+0},
+  {7e1, 7E-1, .7, 7.5e+0},
+  {8e1, 8E-1, .8, 8.5e+0},
+  {9e1, 9E-1, .9, 9.5e+0},
+  {10e1, 10E-1, .10, 10.5e+0},
+  {11e1, 11E-1, .11, 11.5e+0},
+  {12e1, 12E-1, .12, 12.5e+0},
+  {13e1, 13E-1, .13, 13.5e+0},
+  {14e1, 14E-1, .14, 14.5e+0},
+  {15e1, 15E-1, .15, 15.5e+0},
+  {16e1, 16E-1, .16, 16.5e+0},
+  {17e1, 17E-1, .17, 17.5e+0},
+  {18e1, 18E-1, .18, 18.5e+0},
+  {19e1, 19E-1, .19, 19.5e+0},
+  {20e1, 20E-1, .20, 20.5e+0},
+  {21e1, 21E-1, .21, 21.5e+0},
+  {22e1, 22E-1, .22, 22.5e+0},
+  {23e1, 23E-1, .23, 23.5e+0},
+  {24e1, 24E-1, .24, 24.5e+0},
+  {25e1, 25E-1, .25, 25.5e+0},
+  {26e1, 26E-1, .26, 26.5e+0},
+  {27e1, 27E-1, .27, 27.5e+0},
+  {28e1, 28E-1, .28, 28.5e+0},
+  {29e1, 29E-1, .29, 29.5e+0},
+  {30e1, 30E-1, .30, 30.5e+0},
+  {31e1, 31E-1, .31, 31.5e+0},
+  {32e1, 32E-1, .32, 32.5e+0},
+  {33e1, 33E-1, .33, 33.5e+0},
+  {34e1, 34E-1, .34, 34.5e+0},
+  {35e1, 35E-1, .35, 35.5e+0},
+  {36e1, 36E-1, .36, 36.5e+0},
+  {37e1, 37E-1, .37, 37.5e+0},
+  {38e1, 38E-1, .38, 38.5e+0},
+  {39e1, 39E-1, .39, 39.5e+0},
+  {40e1, 40E-1, .40, 40.5e+0},
+  {41e1, 41E-1, .41, 41.5e+0},
+  {42e1, 42E-1, .42, 42.5e+0},
+  {43e1, 43E-1, .43, 43.5e+0},
+  {44e1, 44E-1, .44, 44.5e+0},
+  {45e1, 45E-1, .45, 45.5e+0},
+  {46e1, 46E-1, .46, 46.5e+0},
+  {47e1, 47E-1, .47, 47.5e+0},
+  {48e1, 48E-1, .48, 48.5e+0},
+  {49e1, 49E-1, .49, 49.5e+0},
+  {50e1, 50E-1, .50, 50.5e+0},
+  {51e1, 51E-1, .51, 51.5e+0},
+  {52e1, 52E-1, .52, 52.5e+0},
+  {53e1, 53E-1, .53, 53.5e+0},
+  {54e1, 54E-1, .54, 54.5e+0},
+  {55e1, 55E-1, .55, 55.5e+0},
+  {56e1, 56E-1, .56, 56.5e+0},
+  {57e1, 57E-1, .57, 57.5e+0},
+  {58e1, 58E-1, .58, 58.5e+0},
+  {59e1, 59E-1, .59, 59.5e+0},
+  {60e1, 60E-1, .60, 60.5e+0},
+  {61e1, 61E-1, .61, 61.5e+0},
+  {62e1, 62E-1, .62, 62.5e+0},
+  {63e1, 63E-1, .63, 63.5e+0}
+};
+Test.Expect(exponents[5].x == 5e1);
+Test.Expect(exponents[7].y == 7E-1);
+Test.Expect(exponents[12].z == .12);
+Test.Expect(exponents[63].w == 63.5e+0);
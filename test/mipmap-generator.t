@@ -0,0 +1,90 @@
+#include "include/test.t"
+#include "../samples/include/mipmap-generator.t"
+
+class ReadBackBindings {
+  var rendered : *SampleableTexture2D<float>;
+  var computed : *SampleableTexture2D<float>;
+  var result : *storage Buffer<[]float<4>>;
+}
+
+// Level 1 (8x8) goes to result[0..63] and level 2 (4x4) to result[64..79]; the compute
+// generator's levels follow at result[80..159].
+class ReadBack {
+  compute(8, 8, 1) main(cb : &ComputeBuiltins) {
+    var b = bindings.Get();
+    var coord = cb.globalInvocationId.xy;
+    var result = b.result.Map();
+    result[coord.y * 8u + coord.x] = b.rendered.Load(coord, 1u);
+    result[80u + coord.y * 8u + coord.x] = b.computed.Load(coord, 1u);
+    if (coord.x < 4u && coord.y < 4u) {
+      result[64u + coord.y * 4u + coord.x] = b.rendered.Load(coord, 2u);
+      result[144u + coord.y * 4u + coord.x] = b.computed.Load(coord, 2u);
+    }
+  }
+  var bindings : *BindGroup<ReadBackBindings>;
+}
+
+var device = new Device();
+var size = uint<2>{16, 16};
+var rendered = new sampleable renderable storage Texture2D<RGBA8unorm>(device, size, 3);
+var computed = new sampleable renderable storage Texture2D<RGBA8unorm>(device, size, 3);
+
+// A red checkerboard averages to 0.5 at every coarser level; green covers the left half.
+var width = rendered.MinBufferWidth();
+var buffer = new hostwriteable Buffer<[]ubyte<4>>(device, width * size.y);
+var data = buffer.MapWrite();
+for (var y = 0u; y < size.y; ++y) {
+  for (var x = 0u; x < size.x; ++x) {
+    var texel = ubyte<4>{0ub, 0ub, 0ub, 255ub};
+    if ((x + y) % 2u == 0u) { texel.x = 255ub; }
+    if (x < 8u) { texel.y = 255ub; }
+    data[y * width + x] = texel;
+  }
+}
+data = null;
+var copyEncoder = new CommandEncoder(device);
+rendered.CopyFromBuffer(copyEncoder, buffer, size);
+computed.CopyFromBuffer(copyEncoder, buffer, size);
+device.GetQueue().Submit(copyEncoder.Finish());
+
+MipmapGenerator<RGBA8unorm>.Generate(device, rendered);
+ComputeMipmapGenerator<RGBA8unorm>.Generate(device, computed);
+
+var storageBuf = new storage Buffer<[]float<4>>(device, 160);
+var hostBuf = new hostreadable Buffer<[]float<4>>(device, 160);
+var encoder = new CommandEncoder(device);
+var readBackPass = new ComputePass<ReadBack>(encoder, {
+  bindings = new BindGroup<ReadBackBindings>(device, {
+    rendered = rendered.CreateSampleableView(),
+    computed = computed.CreateSampleableView(),
+    result = storageBuf
+  })
+});
+readBackPass.SetPipeline(new ComputePipeline<ReadBack>(device));
+readBackPass.Dispatch(1, 1, 1);
+readBackPass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+for (var generator = 0u; generator < 2u; ++generator) {
+  for (var level = 1u; level < 3u; ++level) {
+    var levelWidth = 8u;
+    var base = generator * 80u;
+    if (level == 2u) {
+      base += 64u;
+      levelWidth = 4u;
+    }
+    for (var y = 0u; y < levelWidth; ++y) {
+      for (var x = 0u; x < levelWidth; ++x) {
+        var texel = result[base + y * levelWidth + x];
+        var green = 0.0;
+        if (x < levelWidth / 2u) { green = 1.0; }
+        Test.Expect(Math.fabs(texel.x - 0.5) < 0.01);
+        Test.Expect(Math.fabs(texel.y - green) < 0.01);
+        Test.Expect(texel.z == 0.0);
+        Test.Expect(texel.w == 1.0);
+      }
+    }
+  }
+}
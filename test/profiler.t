@@ -0,0 +1,78 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    // Enough work that the pass takes a measurable time.
+    var buffer = bindings.Get().buffer.Map();
+    var x = cb.globalInvocationId.x;
+    for (var i = 0; i < 4096; ++i) {
+      buffer[x] = buffer[x] + i;
+    }
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+var pipeline = new ComputePipeline<Compute>(device);
+var bindings = new BindGroup<ComputeBindings>(device, {buffer = new storage Buffer<[]int>(device, 64)});
+var profiler = new Profiler(device);
+
+// A pass name which needs escaping in the trace: p"\<tab><newline>q.
+var name = [6] new ubyte;
+name[0] = 112ub;
+name[1] = 34ub;
+name[2] = 92ub;
+name[3] = 9ub;
+name[4] = 10ub;
+name[5] = 113ub;
+
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Compute>(encoder, {bindings = bindings}, profiler.Timestamps("fill"));
+computePass.SetPipeline(pipeline);
+computePass.Dispatch(64, 1, 1);
+computePass.End();
+computePass = new ComputePass<Compute>(encoder, {bindings = bindings}, profiler.Timestamps(name));
+computePass.SetPipeline(pipeline);
+computePass.Dispatch(64, 1, 1);
+computePass.End();
+profiler.Resolve(encoder);
+device.GetQueue().Submit(encoder.Finish());
+profiler.ReadAsync();
+while (!profiler.Update()) {
+  System.ProcessEvents();
+}
+// Without timestamp queries (e.g. on SwiftShader), no passes are timed or traced.
+var supported = profiler.IsSupported();
+if (supported) {
+  Test.Expect(profiler.GetDuration("fill") > 0.0);
+  Test.Expect(profiler.GetDuration(name) > 0.0);
+  Test.Expect(profiler.GetEventCount() == 2u);
+} else {
+  Test.Expect(profiler.GetDuration("fill") >= 0.0);
+  Test.Expect(profiler.GetDuration(name) >= 0.0);
+  Test.Expect(profiler.GetEventCount() == 0u);
+}
+Test.Expect(profiler.GetDuration("unknown") == 0.0);
+Test.Expect(profiler.WriteTrace("profiler-trace.json"));
+
+var querySet = new QuerySet(device, 2u);
+Test.Expect(querySet.GetCount() == 2u);
+encoder = new CommandEncoder(device);
+computePass = new ComputePass<Compute>(encoder, {bindings = bindings},
+                                       querySet.CreateTimestampWrites(0u, 1u));
+computePass.SetPipeline(pipeline);
+computePass.Dispatch(64, 1, 1);
+computePass.End();
+querySet.Resolve(encoder);
+device.GetQueue().Submit(encoder.Finish());
+querySet.ReadAsync();
+if (supported) {
+  Test.Expect(querySet.GetElapsed(0u, 1u) > 0.0);
+} else {
+  Test.Expect(querySet.GetElapsed(0u, 1u) >= 0.0);
+}
+Test.Expect(querySet.IsReady());
@@ -0,0 +1,38 @@
+#include "include/test.t"
+#include "../samples/include/readback.t"
+
+var device = new Device();
+var readback = new Readback<uint>(device, 4u);
+
+// Each frame's copy holds {frame, frame + 1, frame + 2, frame + 3}.
+var newest = -1;
+for (var frame = 0; frame < 8; ++frame) {
+  var values = [4]uint{};
+  for (var i = 0; i < 4; ++i) {
+    values[i] = (frame + i) as uint;
+  }
+  var source = new storage Buffer<[]uint>(device, &values);
+  var encoder = new CommandEncoder(device);
+  readback.Copy(encoder, source);
+  device.GetQueue().Submit(encoder.Finish());
+  readback.Request();
+  var result = readback.Get();
+  if (result != null) {
+    // Copies arrive in order, and never from a future frame.
+    Test.Expect(result[0] as int > newest);
+    Test.Expect(result[0] as int <= frame);
+    Test.Expect(result[3] == result[0] + 3u);
+    newest = result[0] as int;
+    result = null;
+  }
+}
+
+// The last frame's copy arrives eventually.
+while (newest != 7) {
+  var result = readback.Get();
+  if (result != null) {
+    Test.Expect(result[3] == result[0] + 3u);
+    newest = result[0] as int;
+    result = null;
+  }
+}
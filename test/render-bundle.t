@@ -0,0 +1,62 @@
+#include "include/test.t"
+
+class CopyBindings {
+  var depth : *unfilterable SampleableTexture2D<float>;
+  var result : *storage Buffer<float<4>>;
+}
+
+class DrawPipeline {
+  vertex main(vb : &VertexBuiltins) {
+    var pos : [3]float<2> = { { -1.0, -1.0 }, { 3.0, -1.0 }, { -1.0, 3.0 } };
+    vb.position = {@pos[vb.vertexIndex], 0.0, 1.0};
+  }
+  fragment main(fb : &FragmentBuiltins) {
+    color.Set(float<4>(1.0, 1.0, 1.0, 1.0));
+  }
+  var color : *ColorOutput<RGBA8unorm>;
+  var depth : *DepthStencilOutput<Depth24Plus>;
+}
+
+class CopyPipeline {
+  compute(1, 1, 1) main(vb : &ComputeBuiltins) {
+    var depth = bindings.Get().depth;
+    var result = bindings.Get().result.Map();
+    result: = depth.Load(uint<2>{0u, 0u}, 0u);
+  }
+  var bindings : *BindGroup<CopyBindings>;
+}
+
+var device = new Device();
+var drawPipeline = new RenderPipeline<DrawPipeline>(device);
+var copyPipeline = new ComputePipeline<CopyPipeline>(device);
+var color = new renderable Texture2D<RGBA8unorm>(device, uint<2>(1, 1));
+var depth = new renderable sampleable Texture2D<Depth24Plus>(device, uint<2>(1, 1));
+var resultBuf = new storage Buffer<float<4>>(device, 1);
+var readbackBuf = new hostreadable Buffer<float<4>>(device, 1);
+var bindings = new BindGroup<CopyBindings>(device, {
+  depth = depth.CreateSampleableView(),
+  result = resultBuf
+});
+
+var bundle = new RenderBundle<DrawPipeline>(device, {});
+bundle.SetPipeline(drawPipeline);
+bundle.Draw(3, 1, 0, 0);
+bundle.Finish();
+// Recording into a finished bundle is reported and ignored.
+bundle.Draw(3, 1, 0, 0);
+
+var encoder = new CommandEncoder(device);
+var renderPass = new RenderPass<DrawPipeline>(encoder, {
+  color = color.CreateColorOutput(LoadOp.Clear),
+  depth = depth.CreateDepthStencilOutput(depthLoadOp = LoadOp.Clear, depthClearValue = 1.0)
+});
+renderPass.ExecuteBundle(bundle);
+renderPass.End();
+var copyPass = new ComputePass<CopyPipeline>(encoder, { bindings = bindings });
+copyPass.SetPipeline(copyPipeline);
+copyPass.Dispatch(1, 1, 1);
+copyPass.End();
+readbackBuf.CopyFromBuffer(encoder, resultBuf);
+device.GetQueue().Submit(encoder.Finish());
+var result = readbackBuf.MapRead()[0];
+Test.Expect(result == 0.0);
@@ -26,7 +26,12 @@ if sys.platform == 'win32':
 else:
   exe_path = os.path.join('out', debug_or_release, 'tj');
 
+# Every shader is run through the SPIR-V validator, so that invalid code generation shows up
+# as diagnostics in the test output.  Fields of uniform and storage classes are reordered, so
+# that every test also checks that host and device code agree on the reordered layouts.
+base_args = ['-O', 'validate', '-l']
+
 for file in files:
   print('test/' + os.path.basename(file));
   sys.stdout.flush();
-  subprocess.call([exe_path, file]);
+  subprocess.call([exe_path] + base_args + [file]);
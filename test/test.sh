@@ -16,5 +16,5 @@ testpath=`dirname $0`
 for file in `ls ${testpath}/*.t`
 do
   echo $file
-  out/Debug/tj < $file
+  out/Debug/tj -O validate -l < $file
 done
@@ -0,0 +1,40 @@
+#include "include/test.t"
+#include "../samples/include/workgroup-size-tuner.t"
+
+class ComputeBindings {
+  var result : *storage Buffer<[]uint>;
+}
+
+class Fill {
+  override groupSize = 64u;
+  compute(groupSize, 1, 1) main(cb : &ComputeBuiltins) {
+    var i = cb.globalInvocationId.x;
+    if (i < 1000u) {
+      bindings.Get().result.Map()[i] = i * 2u;
+    }
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+var storageBuf = new storage Buffer<[]uint>(device, 1000);
+var hostBuf = new hostreadable Buffer<[]uint>(device, 1000);
+var data = Fill{bindings = new BindGroup<ComputeBindings>(device, {result = storageBuf})};
+
+var tuner = new WorkgroupSizeTuner<Fill>(device);
+var candidates = [3]uint{32u, 64u, 128u};
+var best = tuner.Tune(&data, 1000u, &candidates);
+Test.Expect(best == 32u || best == 64u || best == 128u);
+
+// The chosen size still covers every invocation.
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Fill>(encoder, &data);
+computePass.SetPipeline(tuner.Pipeline(best));
+computePass.Dispatch((1000u + best - 1u) / best, 1, 1);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+Test.Expect(result[0] == 0u);
+Test.Expect(result[999] == 1998u);
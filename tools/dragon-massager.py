@@ -15,6 +15,8 @@
 # limitations under the License.
 
 import json
+import struct
+import sys
 
 with open('stanford-dragon.json', 'r') as file:
   data = json.load(file)
@@ -22,6 +24,19 @@ with open('stanford-dragon.json', 'r') as file:
 cells = data["cells"]
 positions = data["positions"]
 
+# With --binary, write the mesh in the in-memory layout of [][3]uint and
+# []float<3> (whose elements are padded to 16 bytes), for use with
+# inline<[][3]uint>("dragon-triangles.bin") and
+# inline<[]float<3>>("dragon-vertices.bin").
+if "--binary" in sys.argv:
+  with open('dragon-triangles.bin', 'wb') as file:
+    for cell in cells:
+      file.write(struct.pack('<3I', cell[0], cell[1], cell[2]))
+  with open('dragon-vertices.bin', 'wb') as file:
+    for position in positions:
+      file.write(struct.pack('<4f', position[0], position[1], position[2], 0.0))
+  sys.exit(0)
+
 count = 0
 print("var dragonTriangles : [" + str(len(cells)) + "][3]uint = {");
 for cell in cells: